@@ -16,11 +16,14 @@ namespace Eos
 
     Application::~Application()
     {
+        m_JobSystem.cleanup();
         m_Engine->cleanup();
     }
 
     void Application::start()
     {
+        m_JobSystem.init(m_Details.jobWorkers);
+
         m_Window->init();
 
         m_Window->setWindowHint(GLFW_RESIZABLE,
@@ -30,6 +33,7 @@ namespace Eos
 
         m_MainEventListener.setupListener(m_Window);
         m_MainEventListener.addDispatcher(&m_MainEventDispatcher);
+        m_Input = m_MainEventListener.getInputState().getSnapshot();
 
         EOS_CORE_LOG_INFO("Initialised Application");
 
@@ -43,6 +47,7 @@ namespace Eos
             m_Details.enableVsync,
             m_Details.framesInFlight,
             m_Details.float64,
+            m_Details.samplerAnisotropy,
             m_Details.swapchainFormat
         };
 
@@ -81,11 +86,19 @@ namespace Eos
         while(!m_Window->shouldClose())
         {
             glfwPollEvents();
+            m_MainEventListener.processEvents();
+            m_Input = m_MainEventListener.getInputState().getSnapshot();
+
+            // The frame is begun first, so update already sees this frame's
+            // descriptor allocators and resources released by its fence
+            RenderInformation info = m_Engine->beginFrame();
 
             m_FrameTimer.tick();
             update(m_FrameTimer.timeElapsed());
 
-            RenderInformation info = m_Engine->preRender();
+            prepare(*(info.cmd));
+
+            m_Engine->beginRenderPass(info);
 
             draw(*(info.cmd));
 
@@ -109,6 +122,7 @@ namespace Eos
         return {}; };
 
     void Application::postEngineInit() {}
+    void Application::prepare(VkCommandBuffer cmd) {}
     void Application::draw(VkCommandBuffer cmd) {}
     void Application::update(double dt) {}
 }
@@ -2,6 +2,7 @@
 
 #include "Eos/EosPCH.hpp"
 
+#include "Eos/Core/JobSystem.hpp"
 #include "Eos/Core/Window.hpp"
 #include "Eos/Core/Logger.hpp"
 #include "Eos/Core/Timer.hpp"
@@ -30,7 +31,10 @@ namespace Eos
         bool customRenderpass = false;
         bool customClearValues = false;
         uint32_t framesInFlight = 1;
+        // 0 uses one worker per hardware thread, minus the main thread
+        uint32_t jobWorkers = 0;
         bool float64 = false;
+        bool samplerAnisotropy = false;
         VkSurfaceFormatKHR swapchainFormat =
             { VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
     };
@@ -48,6 +52,12 @@ namespace Eos
         std::shared_ptr<Window>& m_Window;
 
         Events::EventDispatcher m_MainEventDispatcher;
+
+        // Usable from postEngineInit, the main thread runs jobs while it waits
+        JobSystem m_JobSystem;
+
+        // Input at the start of this frame, safe to pass to other threads
+        std::shared_ptr<const Events::InputSnapshot> m_Input;
     private:
         ApplicationDetails m_Details;
         Timer m_FrameTimer;
@@ -69,7 +79,10 @@ namespace Eos
 
         virtual std::vector<VkClearValue> renderClearValues();
 
+        // Called before the render pass begins, for compute, copies and barriers
+        virtual void prepare(VkCommandBuffer cmd);
         virtual void draw(VkCommandBuffer cmd);
+        // Called after the frame has begun, before prepare
         virtual void update(double dt);
     };
 
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <functional>
+
+namespace Eos
+{
+    // Mixes the hash of value into seed, the order values are combined in
+    // changes the result
+    template <typename T>
+    inline void hashCombine(size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>()(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+}
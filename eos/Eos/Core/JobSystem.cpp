@@ -0,0 +1,202 @@
+#include "JobSystem.hpp"
+
+namespace Eos
+{
+    // The queue owned by the current thread, 0 when it is not a worker
+    static thread_local const JobSystem* s_WorkerOwner = nullptr;
+    static thread_local uint32_t s_WorkerIndex = 0;
+
+    void JobSystem::init(uint32_t workerCount)
+    {
+        if (workerCount == 0)
+        {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        for (uint32_t i = 0; i < workerCount + 1; i++)
+        {
+            m_Queues.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        m_Running = true;
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            m_Workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+        }
+
+        EOS_CORE_LOG_INFO("Created Job System with {} workers", workerCount);
+    }
+
+    void JobSystem::cleanup()
+    {
+        if (m_Workers.empty())
+            return;
+
+        // Jobs can not be dropped, something may be waiting on their counters
+        while (tryRun()) {}
+
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+            m_Running = false;
+        }
+        m_Wake.notify_all();
+
+        for (std::thread& worker : m_Workers)
+        {
+            worker.join();
+        }
+
+        m_Workers.clear();
+        m_Queues.clear();
+    }
+
+    void JobSystem::submit(JobFunction&& function, JobCounter* counter, JobCounter* dependency)
+    {
+        if (counter)
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+        Job job{ std::move(function), counter };
+
+        if (dependency)
+        {
+            std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+
+            if (!dependency->isDone())
+            {
+                dependency->m_Waiting.push_back(std::move(job));
+                return;
+            }
+        }
+
+        push(std::move(job));
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        while (!counter.isDone())
+        {
+            if (!tryRun())
+                std::this_thread::yield();
+        }
+
+        // The job that finished the counter may still be releasing its mutex
+        std::lock_guard<std::mutex> lock(counter.m_Mutex);
+    }
+
+    void JobSystem::push(Job&& job)
+    {
+        WorkerQueue& queue = *m_Queues[getQueueIndex()];
+
+        // Counted before it is visible, a thief could otherwise take it and
+        // decrement first
+        m_Queued.fetch_add(1, std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+        }
+        m_Wake.notify_one();
+    }
+
+    bool JobSystem::pop(uint32_t index, Job& job)
+    {
+        // Own jobs newest first, they are likely still in cache
+        {
+            WorkerQueue& queue = *m_Queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+
+                m_Queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Steal the oldest job, which tends to be the largest piece of work
+        uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+        for (uint32_t i = 1; i < queueCount; i++)
+        {
+            WorkerQueue& queue = *m_Queues[(index + i) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+
+                m_Queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool JobSystem::tryRun()
+    {
+        Job job;
+        if (!pop(getQueueIndex(), job))
+            return false;
+
+        run(job);
+        return true;
+    }
+
+    void JobSystem::run(Job& job)
+    {
+        job.function();
+
+        if (job.counter)
+            finish(*job.counter);
+    }
+
+    void JobSystem::finish(JobCounter& counter)
+    {
+        std::vector<Job> released;
+
+        {
+            std::lock_guard<std::mutex> lock(counter.m_Mutex);
+
+            if (counter.m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                released.swap(counter.m_Waiting);
+        }
+
+        for (Job& job : released)
+        {
+            push(std::move(job));
+        }
+    }
+
+    void JobSystem::workerLoop(uint32_t index)
+    {
+        s_WorkerOwner = this;
+        s_WorkerIndex = index;
+
+        while (true)
+        {
+            if (tryRun())
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_SleepMutex);
+            m_Wake.wait(lock, [this]() {
+                return m_Queued.load(std::memory_order_acquire) > 0 || !m_Running;
+            });
+
+            if (!m_Running && m_Queued.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+    uint32_t JobSystem::getQueueIndex() const
+    {
+        return s_WorkerOwner == this ? s_WorkerIndex : 0;
+    }
+}
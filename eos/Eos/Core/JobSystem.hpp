@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Eos
+{
+    class JobCounter;
+
+    using JobFunction = std::function<void()>;
+
+    struct Job
+    {
+        JobFunction function;
+        JobCounter* counter = nullptr;
+    };
+
+    // Counts the jobs submitted with it that have not finished yet. Has to
+    // outlive those jobs, wait on it before it goes out of scope
+    class EOS_API JobCounter
+    {
+    public:
+        JobCounter() {}
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool isDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+        uint32_t getPending() const { return m_Pending.load(std::memory_order_relaxed); }
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_Pending = 0;
+
+        // Jobs depending on this counter, submitted once it reaches zero
+        std::vector<Job> m_Waiting;
+        std::mutex m_Mutex;
+    };
+
+    // Work stealing scheduler. Every worker owns a deque, taking its newest
+    // job first and stealing the oldest job of the others when it runs out.
+    // Threads that are not workers share one extra deque
+    class EOS_API JobSystem
+    {
+    public:
+        JobSystem() {}
+        JobSystem(const JobSystem&) = delete;
+        ~JobSystem() { cleanup(); }
+
+        // 0 uses one worker per hardware thread, minus the calling thread
+        void init(uint32_t workerCount = 0);
+
+        // Finishes every queued job, then joins the workers
+        void cleanup();
+
+        // counter is incremented now and decremented once the job has run.
+        // With a dependency the job is only queued when it reaches zero
+        void submit(JobFunction&& function, JobCounter* counter = nullptr,
+                JobCounter* dependency = nullptr);
+
+        // Runs queued jobs on the calling thread until counter reaches zero
+        void wait(JobCounter& counter);
+
+        // Calls function(begin, end) over chunks of grainSize and waits for
+        // them. A grainSize of 0 splits into a few chunks per thread
+        template <typename F>
+        void parallelForRange(size_t begin, size_t end, F&& function, size_t grainSize = 0)
+        {
+            if (begin >= end)
+                return;
+
+            if (grainSize == 0)
+                grainSize = std::max<size_t>((end - begin) / ((m_Workers.size() + 1) * 4), 1);
+
+            JobCounter counter;
+            for (size_t start = begin; start < end; start += std::min(grainSize, end - start))
+            {
+                size_t stop = start + std::min(grainSize, end - start);
+
+                submit([&function, start, stop]() { function(start, stop); }, &counter);
+            }
+
+            wait(counter);
+        }
+
+        // Calls function(i) for every i in [begin, end)
+        template <typename F>
+        void parallelFor(size_t begin, size_t end, F&& function, size_t grainSize = 0)
+        {
+            parallelForRange(begin, end, [&function](size_t start, size_t stop) {
+                for (size_t i = start; i < stop; i++)
+                    function(i);
+            }, grainSize);
+        }
+
+        // Worker threads, not counting threads that help while waiting
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+    private:
+        struct WorkerQueue
+        {
+            std::deque<Job> jobs;
+            std::mutex mutex;
+        };
+
+        // Index 0 is shared by every thread that is not a worker
+        std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+        std::vector<std::thread> m_Workers;
+
+        std::atomic<bool> m_Running = false;
+        std::atomic<uint32_t> m_Queued = 0;
+
+        std::mutex m_SleepMutex;
+        std::condition_variable m_Wake;
+    private:
+        void push(Job&& job);
+        bool pop(uint32_t index, Job& job);
+        bool tryRun();
+
+        void run(Job& job);
+        void finish(JobCounter& counter);
+
+        void workerLoop(uint32_t index);
+
+        uint32_t getQueueIndex() const;
+    };
+}
@@ -0,0 +1,335 @@
+#include "AsyncCompute.hpp"
+
+#include "Eos/Engine/GlobalData.hpp"
+#include "Eos/Engine/Initializers.hpp"
+
+namespace Eos
+{
+    void AsyncCompute::init(Queue* computeQueue, Queue* graphicsQueue, uint32_t framesInFlight)
+    {
+        m_ComputeQueue = computeQueue;
+        m_GraphicsQueue = graphicsQueue;
+        m_Device = GlobalData::getDevice();
+
+        VkCommandPoolCreateInfo commandPoolCI = Init::commandPoolCreateInfo(
+                m_ComputeQueue->family);
+        VkFenceCreateInfo fenceCI = Init::fenceCreateInfo(VK_FENCE_CREATE_SIGNALED_BIT);
+
+        m_Frames.resize(framesInFlight);
+        for (FrameData& frame : m_Frames)
+        {
+            EOS_VK_CHECK(vkCreateCommandPool(m_Device, &commandPoolCI, nullptr,
+                        &frame.commandPool));
+
+            VkCommandBufferAllocateInfo cmdAI = Init::commandBufferAllocateInfo(
+                    frame.commandPool, 1);
+            EOS_VK_CHECK(vkAllocateCommandBuffers(m_Device, &cmdAI, &frame.commandBuffer));
+
+            EOS_VK_CHECK(vkCreateFence(m_Device, &fenceCI, nullptr, &frame.fence));
+        }
+
+        if (!isSeparateFamily())
+            EOS_CORE_LOG_WARN("No separate compute queue family, async compute shares the graphics family");
+    }
+
+    void AsyncCompute::cleanup()
+    {
+        // The device is idle, so semaphores that were never waited on can
+        // go straight back to the pool
+        SemaphorePool& semaphorePool = GlobalData::getSemaphorePool();
+        if (m_ComputeSemaphore != VK_NULL_HANDLE)
+            semaphorePool.release(m_ComputeSemaphore);
+        if (m_ReturnSemaphore != VK_NULL_HANDLE)
+            semaphorePool.release(m_ReturnSemaphore);
+
+        m_ComputeSemaphore = VK_NULL_HANDLE;
+        m_ReturnSemaphore = VK_NULL_HANDLE;
+
+        for (FrameData& frame : m_Frames)
+        {
+            vkDestroyFence(m_Device, frame.fence, nullptr);
+            vkDestroyCommandPool(m_Device, frame.commandPool, nullptr);
+        }
+
+        m_Frames.clear();
+
+        m_GraphicsAcquires.clear();
+        m_GraphicsReleases.clear();
+        m_ComputeAcquires.clear();
+    }
+
+    VkCommandBuffer AsyncCompute::begin()
+    {
+        FrameData& frame = m_Frames[m_FrameIndex];
+
+        EOS_VK_CHECK(vkWaitForFences(m_Device, 1, &frame.fence, true, 1000000000));
+        EOS_VK_CHECK(vkResetCommandPool(m_Device, frame.commandPool, 0));
+
+        VkCommandBufferBeginInfo cmdBeginInfo = Init::commandBufferBeginInfo(
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        EOS_VK_CHECK(vkBeginCommandBuffer(frame.commandBuffer, &cmdBeginInfo));
+
+        // Resources handed back by the graphics queue
+        for (const SharedResource& resource : m_ComputeAcquires)
+            addBarrier(m_Barriers, resource, Direction::ToCompute, false);
+        m_Barriers.flush(frame.commandBuffer);
+
+        m_Recording = true;
+        return frame.commandBuffer;
+    }
+
+    void AsyncCompute::submit()
+    {
+        if (!m_Recording)
+        {
+            EOS_CORE_LOG_ERROR("AsyncCompute::submit called without begin");
+            return;
+        }
+
+        FrameData& frame = m_Frames[m_FrameIndex];
+
+        // Releases of resources shared during this submission
+        m_Barriers.flush(frame.commandBuffer);
+
+        EOS_VK_CHECK(vkEndCommandBuffer(frame.commandBuffer));
+
+        VkPipelineStageFlags waitStage = 0;
+        for (const SharedResource& resource : m_ComputeAcquires)
+            waitStage |= static_cast<VkPipelineStageFlags>(resource.computeStage);
+
+        SemaphorePool& semaphorePool = GlobalData::getSemaphorePool();
+        m_ComputeSemaphore = semaphorePool.acquire();
+
+        VkSubmitInfo submit = Init::submitInfo(&frame.commandBuffer);
+        submit.signalSemaphoreCount = 1;
+        submit.pSignalSemaphores = &m_ComputeSemaphore;
+
+        if (m_ReturnSemaphore != VK_NULL_HANDLE)
+        {
+            submit.waitSemaphoreCount = 1;
+            submit.pWaitSemaphores = &m_ReturnSemaphore;
+            submit.pWaitDstStageMask = &waitStage;
+        }
+
+        EOS_VK_CHECK(vkResetFences(m_Device, 1, &frame.fence));
+        EOS_VK_CHECK(m_ComputeQueue->submit(1, &submit, frame.fence));
+
+        if (m_ReturnSemaphore != VK_NULL_HANDLE)
+            semaphorePool.release(m_ReturnSemaphore, frame.fence);
+
+        m_ComputeAcquires.clear();
+        m_ReturnSemaphore = VK_NULL_HANDLE;
+
+        m_Recording = false;
+        m_Submitted = true;
+    }
+
+    void AsyncCompute::shareBuffer(const Buffer& buffer,
+            VkPipelineStageFlags2 computeStage, VkAccessFlags2 computeAccess,
+            VkPipelineStageFlags2 graphicsStage, VkAccessFlags2 graphicsAccess)
+    {
+        SharedResource resource;
+        resource.buffer = &buffer;
+        resource.computeStage = computeStage;
+        resource.computeAccess = computeAccess;
+        resource.graphicsStage = graphicsStage;
+        resource.graphicsAccess = graphicsAccess;
+
+        addBarrier(m_Barriers, resource, Direction::ToGraphics, true);
+
+        m_GraphicsAcquires.push_back(resource);
+        m_GraphicsWaitStage |= graphicsStage;
+    }
+
+    void AsyncCompute::shareImage(Texture2D& texture, const ImageAccess& computeAccess,
+            const ImageAccess& graphicsAccess)
+    {
+        SharedResource resource;
+        resource.texture = &texture;
+        resource.computeStage = computeAccess.stage;
+        resource.computeAccess = computeAccess.access;
+        resource.computeLayout = computeAccess.layout;
+        resource.graphicsStage = graphicsAccess.stage;
+        resource.graphicsAccess = graphicsAccess.access;
+        resource.graphicsLayout = graphicsAccess.layout;
+
+        addBarrier(m_Barriers, resource, Direction::ToGraphics, true);
+
+        // Graphics sees the image in the state left by its acquire
+        texture.imageState.set(graphicsAccess);
+
+        m_GraphicsAcquires.push_back(resource);
+        m_GraphicsWaitStage |= graphicsAccess.stage;
+    }
+
+    void AsyncCompute::nextFrame(uint32_t frameIndex)
+    {
+        m_FrameIndex = frameIndex;
+    }
+
+    void AsyncCompute::recordGraphicsAcquire(VkCommandBuffer cmd)
+    {
+        if (m_GraphicsAcquires.empty())
+            return;
+
+        BarrierBatcher barriers;
+        for (const SharedResource& resource : m_GraphicsAcquires)
+            addBarrier(barriers, resource, Direction::ToGraphics, false);
+        barriers.flush(cmd);
+
+        m_GraphicsReleases.insert(m_GraphicsReleases.end(),
+                m_GraphicsAcquires.begin(), m_GraphicsAcquires.end());
+        m_GraphicsAcquires.clear();
+    }
+
+    void AsyncCompute::recordGraphicsRelease(VkCommandBuffer cmd)
+    {
+        if (m_GraphicsReleases.empty())
+            return;
+
+        BarrierBatcher barriers;
+        m_ComputeAcquires.clear();
+        for (const SharedResource& resource : m_GraphicsReleases)
+        {
+            if (!resource.texture)
+            {
+                addBarrier(barriers, resource, Direction::ToCompute, true);
+                m_ComputeAcquires.push_back(resource);
+                continue;
+            }
+
+            // Graphics may have transitioned parts of the image since acquiring
+            // it, each part is released from the state it is in
+            Texture2D& texture = *resource.texture;
+            VkImageSubresourceRange whole = { texture.aspectFlags, 0, VK_REMAINING_MIP_LEVELS,
+                0, VK_REMAINING_ARRAY_LAYERS };
+
+            for (const ImageState::Range& current : texture.imageState.getRanges(whole))
+            {
+                SharedResource part = resource;
+                part.graphicsLayout = current.access.layout;
+                part.graphicsStage = current.access.stage;
+                part.graphicsAccess = current.access.access;
+                part.baseMipLevel = current.range.baseMipLevel;
+                part.levelCount = current.range.levelCount;
+                part.baseArrayLayer = current.range.baseArrayLayer;
+                part.layerCount = current.range.layerCount;
+
+                addBarrier(barriers, part, Direction::ToCompute, true);
+                m_ComputeAcquires.push_back(part);
+            }
+
+            texture.imageState.set({ resource.computeLayout,
+                    static_cast<VkAccessFlags>(resource.computeAccess),
+                    static_cast<VkPipelineStageFlags>(resource.computeStage) });
+        }
+        barriers.flush(cmd);
+
+        m_GraphicsReleases.clear();
+
+        m_ReturnSemaphore = GlobalData::getSemaphorePool().acquire();
+        m_ReturnRecorded = true;
+    }
+
+    void AsyncCompute::getGraphicsSemaphores(std::vector<VkSemaphore>& waitSemaphores,
+            std::vector<VkPipelineStageFlags>& waitStages,
+            std::vector<VkSemaphore>& signalSemaphores, VkFence completion)
+    {
+        if (m_Submitted)
+        {
+            // Graphics work before the first use of compute results can
+            // overlap with the compute submission
+            waitSemaphores.push_back(m_ComputeSemaphore);
+            waitStages.push_back(m_GraphicsWaitStage != 0 ?
+                    static_cast<VkPipelineStageFlags>(m_GraphicsWaitStage) :
+                    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+            GlobalData::getSemaphorePool().release(m_ComputeSemaphore, completion);
+            m_ComputeSemaphore = VK_NULL_HANDLE;
+        }
+
+        if (m_ReturnRecorded)
+            signalSemaphores.push_back(m_ReturnSemaphore);
+
+        m_Submitted = false;
+        m_ReturnRecorded = false;
+        m_GraphicsWaitStage = 0;
+    }
+
+    void AsyncCompute::addBarrier(BarrierBatcher& barriers, const SharedResource& resource,
+            Direction direction, bool release)
+    {
+        // Within one family the semaphore is enough, only a layout change is
+        // left for the receiving side
+        bool separate = isSeparateFamily();
+        if (!separate && release)
+            return;
+
+        bool toGraphics = direction == Direction::ToGraphics;
+
+        uint32_t srcFamily = toGraphics ? m_ComputeQueue->family : m_GraphicsQueue->family;
+        uint32_t dstFamily = toGraphics ? m_GraphicsQueue->family : m_ComputeQueue->family;
+        if (!separate)
+        {
+            srcFamily = VK_QUEUE_FAMILY_IGNORED;
+            dstFamily = VK_QUEUE_FAMILY_IGNORED;
+        }
+
+        VkPipelineStageFlags2 srcStage = toGraphics ? resource.computeStage : resource.graphicsStage;
+        VkAccessFlags2 srcAccess = toGraphics ? resource.computeAccess : resource.graphicsAccess;
+        VkPipelineStageFlags2 dstStage = toGraphics ? resource.graphicsStage : resource.computeStage;
+        VkAccessFlags2 dstAccess = toGraphics ? resource.graphicsAccess : resource.computeAccess;
+
+        if (release)
+        {
+            // The destination half of a release is ignored
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            dstAccess = VK_ACCESS_2_NONE;
+        }
+        else
+        {
+            // Chains with the semaphore wait on the receiving queue
+            srcStage = separate ? VK_PIPELINE_STAGE_2_NONE : dstStage;
+            srcAccess = VK_ACCESS_2_NONE;
+        }
+
+        if (resource.buffer)
+        {
+            VkBufferMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+            barrier.pNext = nullptr;
+            barrier.srcStageMask = srcStage;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstStageMask = dstStage;
+            barrier.dstAccessMask = dstAccess;
+            barrier.srcQueueFamilyIndex = srcFamily;
+            barrier.dstQueueFamilyIndex = dstFamily;
+            barrier.buffer = resource.buffer->buffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+
+            barriers.bufferBarrier(barrier);
+            return;
+        }
+
+        VkImageMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.pNext = nullptr;
+        barrier.srcStageMask = srcStage;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = dstStage;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = toGraphics ? resource.computeLayout : resource.graphicsLayout;
+        barrier.newLayout = toGraphics ? resource.graphicsLayout : resource.computeLayout;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        barrier.image = resource.texture->image;
+        barrier.subresourceRange.aspectMask = resource.texture->aspectFlags;
+        barrier.subresourceRange.baseMipLevel = resource.baseMipLevel;
+        barrier.subresourceRange.levelCount = resource.levelCount;
+        barrier.subresourceRange.baseArrayLayer = resource.baseArrayLayer;
+        barrier.subresourceRange.layerCount = resource.layerCount;
+
+        barriers.imageBarrier(barrier);
+    }
+}
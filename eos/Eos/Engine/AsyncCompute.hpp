@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/BarrierBatcher.hpp"
+#include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/ImageState.hpp"
+#include "Eos/Engine/Texture.hpp"
+#include "Eos/Engine/Types.hpp"
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Runs compute work on the compute queue alongside the frame's graphics
+    // work. The frame's graphics submission waits on a semaphore rather than
+    // the CPU waiting on a fence.
+    //
+    // Once per frame, between Engine::beginFrame and Engine::postRender:
+    //     VkCommandBuffer cmd = asyncCompute.begin();
+    //     ...record dispatches...
+    //     asyncCompute.shareBuffer(particles, ...);
+    //     asyncCompute.submit();
+    //
+    // Shared resources are handed to the graphics queue for the rest of the
+    // frame and handed back to compute once the frame's draws are done
+    class EOS_API AsyncCompute
+    {
+    public:
+        void init(Queue* computeQueue, Queue* graphicsQueue, uint32_t framesInFlight);
+        void cleanup();
+
+        // Waits until this frame slot's previous compute work has finished
+        VkCommandBuffer begin();
+        void submit();
+
+        // Only valid between begin and submit, after the compute work writing
+        // the resource has been recorded
+        void shareBuffer(const Buffer& buffer,
+                VkPipelineStageFlags2 computeStage, VkAccessFlags2 computeAccess,
+                VkPipelineStageFlags2 graphicsStage, VkAccessFlags2 graphicsAccess);
+        void shareImage(Texture2D& texture, const ImageAccess& computeAccess,
+                const ImageAccess& graphicsAccess);
+
+        bool isSeparateFamily() const
+            { return m_ComputeQueue->family != m_GraphicsQueue->family; }
+
+        // Used by the engine when recording and submitting the frame
+        void nextFrame(uint32_t frameIndex);
+        void recordGraphicsAcquire(VkCommandBuffer cmd);
+        void recordGraphicsRelease(VkCommandBuffer cmd);
+        // completion is the fence of the graphics submission using the semaphores
+        void getGraphicsSemaphores(std::vector<VkSemaphore>& waitSemaphores,
+                std::vector<VkPipelineStageFlags>& waitStages,
+                std::vector<VkSemaphore>& signalSemaphores, VkFence completion);
+    private:
+        struct SharedResource
+        {
+            const Buffer* buffer = nullptr;
+            Texture2D* texture = nullptr;
+
+            VkPipelineStageFlags2 computeStage;
+            VkAccessFlags2 computeAccess;
+            VkPipelineStageFlags2 graphicsStage;
+            VkAccessFlags2 graphicsAccess;
+
+            VkImageLayout computeLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkImageLayout graphicsLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            // Levels and layers covered, graphics can leave them in different states
+            uint32_t baseMipLevel = 0;
+            uint32_t levelCount = VK_REMAINING_MIP_LEVELS;
+            uint32_t baseArrayLayer = 0;
+            uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS;
+        };
+
+        struct FrameData
+        {
+            VkCommandPool commandPool;
+            VkCommandBuffer commandBuffer;
+            VkFence fence;
+        };
+
+        enum class Direction
+        {
+            ToGraphics,
+            ToCompute
+        };
+
+        std::vector<FrameData> m_Frames;
+        uint32_t m_FrameIndex = 0;
+
+        bool m_Recording = false;
+        bool m_Submitted = false;
+        bool m_ReturnRecorded = false;
+        VkPipelineStageFlags2 m_GraphicsWaitStage = 0;
+
+        // Ownership releases recorded at the end of the compute submission
+        BarrierBatcher m_Barriers;
+
+        // Resources waiting to be acquired by graphics this frame, then
+        // released back at the end of it
+        std::vector<SharedResource> m_GraphicsAcquires;
+        std::vector<SharedResource> m_GraphicsReleases;
+
+        // Released by graphics, acquired by the next compute submission after
+        // waiting on m_ReturnSemaphore
+        std::vector<SharedResource> m_ComputeAcquires;
+
+        // Taken from the semaphore pool per submission. Signalled by compute
+        // for graphics, and by graphics when it hands resources back
+        VkSemaphore m_ComputeSemaphore = VK_NULL_HANDLE;
+        VkSemaphore m_ReturnSemaphore = VK_NULL_HANDLE;
+
+        Queue* m_ComputeQueue = nullptr;
+        Queue* m_GraphicsQueue = nullptr;
+
+        VkDevice m_Device;
+    private:
+        void addBarrier(BarrierBatcher& barriers, const SharedResource& resource,
+                Direction direction, bool release);
+    };
+}
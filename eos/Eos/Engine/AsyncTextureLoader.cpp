@@ -0,0 +1,290 @@
+#include "AsyncTextureLoader.hpp"
+
+#include "Eos/Engine/GlobalData.hpp"
+#include "Eos/Engine/Initializers.hpp"
+
+#include <algorithm>
+
+namespace Eos
+{
+    void AsyncTextureLoader::init(Queue* queue, uint32_t framesInFlight, uint32_t workerCount)
+    {
+        m_Queue = queue;
+        m_FramesInFlight = framesInFlight;
+
+        VkCommandPoolCreateInfo poolInfo = Init::commandPoolCreateInfo(m_Queue->family,
+                VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        EOS_VK_CHECK(vkCreateCommandPool(GlobalData::getDevice(), &poolInfo, nullptr,
+                    &m_CommandPool));
+
+        // Magenta and black checkerboard shown while textures are loading
+        m_Placeholder.createImage(VK_FORMAT_R8G8B8A8_UNORM,
+                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                { 2, 2, 1 }, VMA_MEMORY_USAGE_GPU_ONLY);
+        m_Placeholder.createImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+        m_Placeholder.createSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+        m_Placeholder.transferDataToImage({ 0xFFFF00FF, 0xFF000000, 0xFF000000, 0xFFFF00FF });
+
+        if (workerCount == 0)
+        {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = std::clamp(hardwareThreads > 1 ? hardwareThreads - 1 : 1, 1u, 4u);
+        }
+
+        m_Running = true;
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            m_Workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+        }
+
+        EOS_CORE_LOG_INFO("Created Async Texture Loader with {} workers", workerCount);
+    }
+
+    void AsyncTextureLoader::cleanup()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_RequestMutex);
+            m_Running = false;
+            m_Requests.clear();
+        }
+        m_RequestCondition.notify_all();
+
+        for (std::thread& worker : m_Workers)
+        {
+            worker.join();
+        }
+        m_Workers.clear();
+
+        VkDevice device = GlobalData::getDevice();
+
+        for (UploadBatch& batch : m_InFlight)
+        {
+            vkWaitForFences(device, 1, &batch.fence, true, UINT64_MAX);
+
+            for (PreparedUpload& upload : batch.uploads)
+            {
+                upload.stagingBuffer.destroy();
+                m_Textures.push_back(upload.handle);
+            }
+
+            m_FreeBatches.push_back(batch);
+        }
+        m_InFlight.clear();
+
+        for (PreparedUpload& upload : m_Prepared)
+        {
+            upload.stagingBuffer.destroy();
+            m_Textures.push_back(upload.handle);
+        }
+        m_Prepared.clear();
+
+        for (UploadBatch& batch : m_FreeBatches)
+            vkDestroyFence(device, batch.fence, nullptr);
+        m_FreeBatches.clear();
+
+        vkDestroyCommandPool(device, m_CommandPool, nullptr);
+
+        // Handles may outlive the loader, so the images are released here
+        for (TextureHandle& handle : m_Textures)
+            handle->m_Texture.deleteImage();
+        m_Textures.clear();
+
+        for (RetiredTexture& retired : m_Retired)
+            retired.handle->m_Texture.deleteImage();
+        m_Retired.clear();
+
+        m_Placeholder.deleteImage();
+    }
+
+    TextureHandle AsyncTextureLoader::load(const char* file, bool generateMips,
+            TextureReadyFunction onReady)
+    {
+        TextureHandle handle = std::make_shared<AsyncTexture>();
+        handle->m_Placeholder = &m_Placeholder;
+
+        {
+            std::lock_guard<std::mutex> lock(m_RequestMutex);
+            m_Requests.push_back({ file, generateMips, handle, onReady });
+        }
+        m_RequestCondition.notify_one();
+
+        return handle;
+    }
+
+    void AsyncTextureLoader::update(uint64_t frame)
+    {
+        m_Frame = frame;
+
+        VkDevice device = GlobalData::getDevice();
+
+        for (auto it = m_InFlight.begin(); it != m_InFlight.end();)
+        {
+            if (vkGetFenceStatus(device, it->fence) != VK_SUCCESS)
+            {
+                it++;
+                continue;
+            }
+
+            for (PreparedUpload& upload : it->uploads)
+            {
+                upload.stagingBuffer.destroy();
+                upload.handle->m_Ready.store(true, std::memory_order_release);
+
+                m_Textures.push_back(upload.handle);
+
+                if (upload.onReady)
+                    upload.onReady(upload.handle);
+            }
+
+            it->uploads.clear();
+            m_FreeBatches.push_back(*it);
+            it = m_InFlight.erase(it);
+        }
+
+        m_Retired.erase(std::remove_if(m_Retired.begin(), m_Retired.end(),
+                    [&](RetiredTexture& retired) {
+                        if (retired.frame + m_FramesInFlight > m_Frame)
+                            return false;
+
+                        retired.handle->m_Texture.deleteImage();
+                        return true;
+                    }), m_Retired.end());
+
+        // Only the loader holds the handle, the texture is no longer used
+        for (auto it = m_Textures.begin(); it != m_Textures.end();)
+        {
+            if (it->use_count() == 1)
+            {
+                m_Retired.push_back({ std::move(*it), m_Frame });
+                it = m_Textures.erase(it);
+                continue;
+            }
+
+            it++;
+        }
+
+        std::vector<PreparedUpload> prepared;
+        {
+            std::lock_guard<std::mutex> lock(m_PreparedMutex);
+            if (m_Prepared.empty())
+                return;
+
+            // Take as many uploads as fit in one batch, at least one is always
+            // taken so that large textures still make progress
+            size_t batchSize = 0;
+            size_t count = 0;
+            while (count < m_Prepared.size() &&
+                    (count == 0 || batchSize + m_Prepared[count].size <= s_MaxBatchSize))
+            {
+                batchSize += m_Prepared[count].size;
+                count++;
+            }
+
+            prepared.assign(std::make_move_iterator(m_Prepared.begin()),
+                    std::make_move_iterator(m_Prepared.begin() + count));
+            m_Prepared.erase(m_Prepared.begin(), m_Prepared.begin() + count);
+        }
+
+        UploadBatch batch = getBatch();
+
+        VkCommandBufferBeginInfo beginInfo = Init::commandBufferBeginInfo(
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        EOS_VK_CHECK(vkBeginCommandBuffer(batch.commandBuffer, &beginInfo));
+
+        for (PreparedUpload& upload : prepared)
+        {
+            upload.handle->m_Texture.recordBufferToImage(batch.commandBuffer,
+                    upload.stagingBuffer.buffer, upload.regions);
+        }
+
+        EOS_VK_CHECK(vkEndCommandBuffer(batch.commandBuffer));
+
+        VkSubmitInfo submit = Init::submitInfo(&batch.commandBuffer);
+        EOS_VK_CHECK(m_Queue->submit(1, &submit, batch.fence));
+
+        batch.uploads = std::move(prepared);
+        m_InFlight.push_back(std::move(batch));
+    }
+
+    size_t AsyncTextureLoader::getPendingCount()
+    {
+        size_t count = m_InFlight.size();
+
+        {
+            std::lock_guard<std::mutex> lock(m_RequestMutex);
+            count += m_Requests.size();
+        }
+
+        std::lock_guard<std::mutex> lock(m_PreparedMutex);
+        return count + m_Prepared.size();
+    }
+
+    void AsyncTextureLoader::workerLoop()
+    {
+        while (true)
+        {
+            LoadRequest request;
+            {
+                std::unique_lock<std::mutex> lock(m_RequestMutex);
+                m_RequestCondition.wait(lock, [&]() {
+                        return !m_Running || !m_Requests.empty();
+                    });
+
+                if (!m_Running)
+                    return;
+
+                request = std::move(m_Requests.front());
+                m_Requests.pop_front();
+            }
+
+            PreparedUpload upload;
+            upload.handle = request.handle;
+            upload.onReady = request.onReady;
+
+            if (!request.handle->m_Texture.prepareFromFile(request.file.c_str(),
+                        request.generateMips, upload.stagingBuffer, upload.regions))
+            {
+                // The image may have been created before the load failed
+                request.handle->m_Texture.deleteImage();
+                if (upload.stagingBuffer.size > 0)
+                    upload.stagingBuffer.destroy();
+
+                request.handle->m_Failed.store(true, std::memory_order_release);
+                continue;
+            }
+
+            VmaAllocationInfo allocationInfo;
+            vmaGetAllocationInfo(GlobalData::getAllocator(), upload.stagingBuffer.allocation,
+                    &allocationInfo);
+            upload.size = allocationInfo.size;
+
+            std::lock_guard<std::mutex> lock(m_PreparedMutex);
+            m_Prepared.push_back(std::move(upload));
+        }
+    }
+
+    AsyncTextureLoader::UploadBatch AsyncTextureLoader::getBatch()
+    {
+        if (!m_FreeBatches.empty())
+        {
+            UploadBatch batch = m_FreeBatches.back();
+            m_FreeBatches.pop_back();
+
+            EOS_VK_CHECK(vkResetFences(GlobalData::getDevice(), 1, &batch.fence));
+            EOS_VK_CHECK(vkResetCommandBuffer(batch.commandBuffer, 0));
+
+            return batch;
+        }
+
+        UploadBatch batch;
+
+        VkCommandBufferAllocateInfo allocInfo = Init::commandBufferAllocateInfo(m_CommandPool, 1);
+        EOS_VK_CHECK(vkAllocateCommandBuffers(GlobalData::getDevice(), &allocInfo,
+                    &batch.commandBuffer));
+
+        VkFenceCreateInfo fenceInfo = Init::fenceCreateInfo();
+        EOS_VK_CHECK(vkCreateFence(GlobalData::getDevice(), &fenceInfo, nullptr, &batch.fence));
+
+        return batch;
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/Texture.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    class EOS_API AsyncTexture
+    {
+    public:
+        bool isReady() const { return m_Ready.load(std::memory_order_acquire); }
+        bool hasFailed() const { return m_Failed.load(std::memory_order_acquire); }
+
+        // Returns the placeholder until the texture has been uploaded
+        Texture2D& get() { return isReady() ? m_Texture : *m_Placeholder; }
+    private:
+        friend class AsyncTextureLoader;
+
+        Texture2D m_Texture;
+        Texture2D* m_Placeholder;
+
+        std::atomic<bool> m_Ready = false;
+        std::atomic<bool> m_Failed = false;
+    };
+
+    using TextureHandle = std::shared_ptr<AsyncTexture>;
+    using TextureReadyFunction = std::function<void(TextureHandle)>;
+
+    // Decodes textures on worker threads and uploads them in batches on the
+    // graphics queue. Uploads are submitted and completed from update, which
+    // the engine calls once per frame
+    class EOS_API AsyncTextureLoader
+    {
+    public:
+        void init(Queue* queue, uint32_t framesInFlight, uint32_t workerCount = 0);
+        void cleanup();
+
+        TextureHandle load(const char* file, bool generateMips = true,
+                TextureReadyFunction onReady = nullptr);
+
+        void update(uint64_t frame);
+
+        Texture2D& getPlaceholder() { return m_Placeholder; }
+
+        size_t getPendingCount();
+    private:
+        struct LoadRequest
+        {
+            std::string file;
+            bool generateMips;
+            TextureHandle handle;
+            TextureReadyFunction onReady;
+        };
+
+        struct PreparedUpload
+        {
+            TextureHandle handle;
+            TextureReadyFunction onReady;
+
+            Buffer stagingBuffer;
+            std::vector<VkBufferImageCopy> regions;
+            size_t size;
+        };
+
+        struct UploadBatch
+        {
+            VkCommandBuffer commandBuffer;
+            VkFence fence;
+
+            std::vector<PreparedUpload> uploads;
+        };
+
+        struct RetiredTexture
+        {
+            TextureHandle handle;
+            uint64_t frame;
+        };
+
+        // Limits how much staging data is recorded into a single submission
+        static const size_t s_MaxBatchSize = 64 * 1024 * 1024;
+
+        std::vector<std::thread> m_Workers;
+        std::atomic<bool> m_Running = false;
+
+        std::deque<LoadRequest> m_Requests;
+        std::mutex m_RequestMutex;
+        std::condition_variable m_RequestCondition;
+
+        std::vector<PreparedUpload> m_Prepared;
+        std::mutex m_PreparedMutex;
+
+        std::vector<UploadBatch> m_InFlight;
+        std::vector<UploadBatch> m_FreeBatches;
+
+        // Textures are retired once the loader holds the only handle, and
+        // destroyed when no frame in flight can reference them
+        std::vector<TextureHandle> m_Textures;
+        std::vector<RetiredTexture> m_Retired;
+
+        uint32_t m_FramesInFlight = 0;
+        uint64_t m_Frame = 0;
+
+        Texture2D m_Placeholder;
+
+        Queue* m_Queue;
+        VkCommandPool m_CommandPool;
+    private:
+        void workerLoop();
+
+        UploadBatch getBatch();
+    };
+}
@@ -0,0 +1,103 @@
+#include "BarrierBatcher.hpp"
+
+namespace Eos
+{
+    BarrierBatcher& BarrierBatcher::transition(Texture2D& texture, const ImageAccess& access,
+            uint32_t baseMipLevel, uint32_t levelCount, uint32_t baseArrayLayer,
+            uint32_t layerCount)
+    {
+        VkImageSubresourceRange range;
+        range.aspectMask = texture.aspectFlags;
+        range.baseMipLevel = baseMipLevel;
+        range.levelCount = levelCount;
+        range.baseArrayLayer = baseArrayLayer;
+        range.layerCount = layerCount;
+
+        texture.imageState.getBarriers(texture.image, range, access, m_ImageBarriers);
+
+        return *this;
+    }
+
+    BarrierBatcher& BarrierBatcher::imageBarrier(const VkImageMemoryBarrier2& barrier)
+    {
+        m_ImageBarriers.push_back(barrier);
+
+        return *this;
+    }
+
+    BarrierBatcher& BarrierBatcher::bufferBarrier(const Buffer& buffer,
+            VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+            VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess,
+            VkDeviceSize offset, VkDeviceSize size)
+    {
+        VkBufferMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.pNext = nullptr;
+        barrier.srcStageMask = srcStage;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = dstStage;
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffer.buffer;
+        barrier.offset = offset;
+        barrier.size = size;
+
+        return bufferBarrier(barrier);
+    }
+
+    BarrierBatcher& BarrierBatcher::bufferBarrier(const VkBufferMemoryBarrier2& barrier)
+    {
+        m_BufferBarriers.push_back(barrier);
+
+        return *this;
+    }
+
+    BarrierBatcher& BarrierBatcher::memoryBarrier(VkPipelineStageFlags2 srcStage,
+            VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+    {
+        VkMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.pNext = nullptr;
+        barrier.srcStageMask = srcStage;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = dstStage;
+        barrier.dstAccessMask = dstAccess;
+
+        m_MemoryBarriers.push_back(barrier);
+
+        return *this;
+    }
+
+    void BarrierBatcher::flush(VkCommandBuffer cmd)
+    {
+        if (empty())
+            return;
+
+        VkDependencyInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        info.pNext = nullptr;
+        info.memoryBarrierCount = m_MemoryBarriers.size();
+        info.pMemoryBarriers = m_MemoryBarriers.data();
+        info.bufferMemoryBarrierCount = m_BufferBarriers.size();
+        info.pBufferMemoryBarriers = m_BufferBarriers.data();
+        info.imageMemoryBarrierCount = m_ImageBarriers.size();
+        info.pImageMemoryBarriers = m_ImageBarriers.data();
+
+        vkCmdPipelineBarrier2(cmd, &info);
+
+        clear();
+    }
+
+    bool BarrierBatcher::empty() const
+    {
+        return m_MemoryBarriers.empty() && m_BufferBarriers.empty() && m_ImageBarriers.empty();
+    }
+
+    void BarrierBatcher::clear()
+    {
+        m_MemoryBarriers.clear();
+        m_BufferBarriers.clear();
+        m_ImageBarriers.clear();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/ImageState.hpp"
+#include "Eos/Engine/Texture.hpp"
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Gathers barriers so that they are recorded with a single
+    // vkCmdPipelineBarrier2 when flushed
+    class EOS_API BarrierBatcher
+    {
+    public:
+        // Barrier from the tracked state of the texture, nothing is added when
+        // the levels and layers are already usable with access
+        BarrierBatcher& transition(Texture2D& texture, const ImageAccess& access,
+                uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS,
+                uint32_t baseArrayLayer = 0, uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+
+        BarrierBatcher& imageBarrier(const VkImageMemoryBarrier2& barrier);
+
+        BarrierBatcher& bufferBarrier(const Buffer& buffer,
+                VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+                VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess,
+                VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+        BarrierBatcher& bufferBarrier(const VkBufferMemoryBarrier2& barrier);
+
+        BarrierBatcher& memoryBarrier(VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+                VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess);
+
+        // Records every pending barrier into cmd and clears them
+        void flush(VkCommandBuffer cmd);
+
+        bool empty() const;
+        void clear();
+    private:
+        std::vector<VkMemoryBarrier2> m_MemoryBarriers;
+        std::vector<VkBufferMemoryBarrier2> m_BufferBarriers;
+        std::vector<VkImageMemoryBarrier2> m_ImageBarriers;
+    };
+}
@@ -1,14 +1,18 @@
 #include "Buffer.hpp"
 
+#include "Eos/Engine/Defragmenter.hpp"
 #include "Eos/Engine/GlobalData.hpp"
 
 namespace Eos
 {
     void Buffer::destroy()
     {
+        GlobalData::getDescriptorSetCache().invalidate(buffer);
+
         if (!m_AddedToQueue)
         {
-            vmaDestroyBuffer(GlobalData::getAllocator(), buffer, allocation);
+            GlobalData::getMemoryStats().untrack(allocation);
+            GlobalData::getDefragmenter().destroyBuffer(buffer, allocation);
         }
     }
 
@@ -21,6 +25,9 @@ namespace Eos
         info.size = allocSize;
         info.usage = usage;
 
+        this->size = allocSize;
+        this->usage = usage;
+
         VmaAllocationCreateInfo vmaAllocInfo{};
         vmaAllocInfo.usage = memoryUsage;
         vmaAllocInfo.flags = flags;
@@ -28,6 +35,9 @@ namespace Eos
         EOS_VK_CHECK(vmaCreateBuffer(GlobalData::getAllocator(),
                     &info, &vmaAllocInfo, &buffer,
                     &allocation, nullptr));
+
+        GlobalData::getMemoryStats().track(
+                MemoryStats::getBufferCategory(usage, memoryUsage), allocation);
     }
 
     void Buffer::create(size_t allocSize, VkBufferUsageFlags usage,
@@ -43,6 +53,11 @@ namespace Eos
         info.queueFamilyIndexCount = static_cast<uint32_t>(queues.size());
         info.pQueueFamilyIndices = queues.data();
 
+        this->size = allocSize;
+        this->usage = usage;
+        this->sharingMode = sharingMode;
+        this->queueFamilies = queues;
+
         VmaAllocationCreateInfo vmaAllocInfo{};
         vmaAllocInfo.usage = memoryUsage;
         vmaAllocInfo.flags = flags;
@@ -50,14 +65,18 @@ namespace Eos
         EOS_VK_CHECK(vmaCreateBuffer(GlobalData::getAllocator(),
                     &info, &vmaAllocInfo, &buffer,
                     &allocation, nullptr));
+
+        GlobalData::getMemoryStats().track(
+                MemoryStats::getBufferCategory(usage, memoryUsage), allocation);
     }
 
     void Buffer::addToDeletionQueue(DeletionQueue& deletionQueue)
     {
         m_AddedToQueue = true;
         deletionQueue.pushFunction([=]() {
-                vmaDestroyBuffer(GlobalData::getAllocator(),
-                        buffer, allocation);
+                GlobalData::getDescriptorSetCache().invalidate(buffer);
+                GlobalData::getMemoryStats().untrack(allocation);
+                GlobalData::getDefragmenter().destroyBuffer(buffer, allocation);
                 });
     }
 }
@@ -14,6 +14,11 @@ namespace Eos
     public:
         VkBuffer buffer;
         VmaAllocation allocation;
+
+        VkDeviceSize size = 0;
+        VkBufferUsageFlags usage = 0;
+        VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        std::vector<uint32_t> queueFamilies;
     public:
         Buffer() {}
         ~Buffer() {}
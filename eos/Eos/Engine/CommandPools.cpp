@@ -0,0 +1,204 @@
+#include "CommandPools.hpp"
+
+#include "Eos/Engine/Initializers.hpp"
+
+namespace Eos
+{
+    void CommandPools::init(VkDevice device)
+    {
+        m_Device = device;
+    }
+
+    void CommandPools::cleanup()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (auto& [key, pool] : m_Pools)
+            vkDestroyCommandPool(m_Device, pool->pool, nullptr);
+        for (std::unique_ptr<ThreadPool>& pool : m_Released)
+            vkDestroyCommandPool(m_Device, pool->pool, nullptr);
+
+        m_Pools.clear();
+        m_Released.clear();
+        m_Allocated = 0;
+    }
+
+    VkCommandBuffer CommandPools::acquire(uint32_t family, VkCommandBufferLevel level)
+    {
+        ThreadPool& pool = getPool(family);
+
+        std::vector<VkCommandBuffer>& freeBuffers =
+            level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? pool.primary : pool.secondary;
+
+        if (freeBuffers.empty())
+            recycle(pool);
+
+        if (!freeBuffers.empty())
+        {
+            VkCommandBuffer cmd = freeBuffers.back();
+            freeBuffers.pop_back();
+            updateCounts(pool);
+
+            EOS_VK_CHECK(vkResetCommandBuffer(cmd, 0));
+            return cmd;
+        }
+
+        VkCommandBuffer cmd;
+        VkCommandBufferAllocateInfo cmdAI = Init::commandBufferAllocateInfo(pool.pool, 1, level);
+        EOS_VK_CHECK(vkAllocateCommandBuffers(m_Device, &cmdAI, &cmd));
+
+        pool.levels[cmd] = level;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Allocated++;
+        }
+
+        return cmd;
+    }
+
+    void CommandPools::release(VkCommandBuffer cmd, uint32_t family, VkFence fence)
+    {
+        ThreadPool& pool = getPool(family);
+
+        auto it = pool.levels.find(cmd);
+        if (it == pool.levels.end())
+        {
+            EOS_CORE_LOG_ERROR("Command buffer released on a thread or family it was not acquired from");
+            return;
+        }
+
+        if (fence == VK_NULL_HANDLE)
+        {
+            if (it->second == VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+                pool.primary.push_back(cmd);
+            else
+                pool.secondary.push_back(cmd);
+        }
+        else
+        {
+            pool.pending.push_back({ cmd, it->second, fence });
+        }
+
+        updateCounts(pool);
+    }
+
+    void CommandPools::releaseThread()
+    {
+        std::thread::id id = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (auto it = m_Pools.begin(); it != m_Pools.end();)
+        {
+            if (it->first.thread != id)
+            {
+                it++;
+                continue;
+            }
+
+            m_Released.push_back(std::move(it->second));
+            it = m_Pools.erase(it);
+        }
+    }
+
+    void CommandPools::update()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // No thread owns these any more, so they can be recycled from here
+        for (size_t i = 0; i < m_Released.size();)
+        {
+            ThreadPool& pool = *m_Released[i];
+
+            recycle(pool);
+            if (!pool.pending.empty())
+            {
+                i++;
+                continue;
+            }
+
+            m_Allocated -= static_cast<uint32_t>(pool.levels.size());
+            vkDestroyCommandPool(m_Device, pool.pool, nullptr);
+
+            m_Released[i] = std::move(m_Released.back());
+            m_Released.pop_back();
+        }
+    }
+
+    CommandPools::Statistics CommandPools::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Statistics statistics;
+        statistics.pools = static_cast<uint32_t>(m_Pools.size() + m_Released.size());
+        statistics.allocated = m_Allocated;
+
+        // The owning threads keep changing these, so only approximate
+        for (auto& [key, pool] : m_Pools)
+        {
+            statistics.pending += pool->pendingCount.load(std::memory_order_relaxed);
+            statistics.free += pool->freeCount.load(std::memory_order_relaxed);
+        }
+        for (std::unique_ptr<ThreadPool>& pool : m_Released)
+        {
+            statistics.pending += pool->pendingCount.load(std::memory_order_relaxed);
+            statistics.free += pool->freeCount.load(std::memory_order_relaxed);
+        }
+
+        return statistics;
+    }
+
+    CommandPools::ThreadPool& CommandPools::getPool(uint32_t family)
+    {
+        PoolKey key = { std::this_thread::get_id(), family };
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Pools.find(key);
+        if (it != m_Pools.end())
+            return *it->second;
+
+        std::unique_ptr<ThreadPool> pool = std::make_unique<ThreadPool>();
+
+        VkCommandPoolCreateInfo poolCI = Init::commandPoolCreateInfo(family,
+                VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        EOS_VK_CHECK(vkCreateCommandPool(m_Device, &poolCI, nullptr, &pool->pool));
+
+        ThreadPool& result = *pool;
+        m_Pools[key] = std::move(pool);
+
+        return result;
+    }
+
+    void CommandPools::recycle(ThreadPool& pool)
+    {
+        for (size_t i = 0; i < pool.pending.size();)
+        {
+            const PendingBuffer& pending = pool.pending[i];
+            if (vkGetFenceStatus(m_Device, pending.fence) != VK_SUCCESS)
+            {
+                i++;
+                continue;
+            }
+
+            if (pending.level == VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+                pool.primary.push_back(pending.cmd);
+            else
+                pool.secondary.push_back(pending.cmd);
+
+            pool.pending[i] = pool.pending.back();
+            pool.pending.pop_back();
+        }
+
+        updateCounts(pool);
+    }
+
+    void CommandPools::updateCounts(ThreadPool& pool)
+    {
+        pool.freeCount.store(static_cast<uint32_t>(pool.primary.size() + pool.secondary.size()),
+                std::memory_order_relaxed);
+        pool.pendingCount.store(static_cast<uint32_t>(pool.pending.size()),
+                std::memory_order_relaxed);
+    }
+}
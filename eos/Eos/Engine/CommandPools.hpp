@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Command buffers for any queue family, handed out from a VkCommandPool
+    // owned by the calling thread. Released buffers are reset and reused once
+    // the fence they were submitted with has signalled
+    class EOS_API CommandPools
+    {
+    public:
+        struct Statistics
+        {
+            uint32_t pools = 0;
+            uint32_t allocated = 0;
+            uint32_t pending = 0;
+            uint32_t free = 0;
+        };
+
+    public:
+        void init(VkDevice device);
+        void cleanup();
+
+        // Has to be released on the same thread it was acquired on
+        VkCommandBuffer acquire(uint32_t family,
+                VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+        // A fence of VK_NULL_HANDLE means the buffer is not in use by the GPU
+        void release(VkCommandBuffer cmd, uint32_t family, VkFence fence = VK_NULL_HANDLE);
+
+        // Call before a thread that used acquire exits. Its pools are
+        // destroyed by update once their pending buffers have finished
+        void releaseThread();
+
+        // Destroys the pools of released threads that are no longer in use
+        void update();
+
+        Statistics getStatistics();
+    private:
+        struct PendingBuffer
+        {
+            VkCommandBuffer cmd;
+            VkCommandBufferLevel level;
+            VkFence fence;
+        };
+
+        struct ThreadPool
+        {
+            VkCommandPool pool;
+
+            std::vector<VkCommandBuffer> primary;
+            std::vector<VkCommandBuffer> secondary;
+            std::vector<PendingBuffer> pending;
+
+            // Tracks the level of every buffer allocated from this pool
+            std::unordered_map<VkCommandBuffer, VkCommandBufferLevel> levels;
+
+            // Copies of the sizes above, the lists are only touched by the
+            // owning thread but the statistics are read from any
+            std::atomic<uint32_t> freeCount = 0;
+            std::atomic<uint32_t> pendingCount = 0;
+        };
+
+        struct PoolKey
+        {
+            std::thread::id thread;
+            uint32_t family;
+
+            bool operator==(const PoolKey& other) const
+            {
+                return thread == other.thread && family == other.family;
+            }
+        };
+
+        struct PoolKeyHash
+        {
+            std::size_t operator()(const PoolKey& key) const
+            {
+                return std::hash<std::thread::id>()(key.thread) ^
+                    (std::hash<uint32_t>()(key.family) << 1);
+            }
+        };
+
+        std::unordered_map<PoolKey, std::unique_ptr<ThreadPool>, PoolKeyHash> m_Pools;
+        std::vector<std::unique_ptr<ThreadPool>> m_Released;
+        std::mutex m_Mutex;
+
+        uint32_t m_Allocated = 0;
+
+        VkDevice m_Device;
+    private:
+        ThreadPool& getPool(uint32_t family);
+        void recycle(ThreadPool& pool);
+        void updateCounts(ThreadPool& pool);
+    };
+}
@@ -0,0 +1,228 @@
+#include "ComputeJobs.hpp"
+
+#include "Eos/Engine/GlobalData.hpp"
+#include "Eos/Engine/Initializers.hpp"
+
+namespace Eos
+{
+    bool ComputeTicket::isReady() const
+    {
+        return !m_System || m_System->isComplete(m_Value);
+    }
+
+    bool ComputeTicket::wait(uint64_t timeout) const
+    {
+        return !m_System || m_System->wait(m_Value, timeout);
+    }
+
+    void ComputeJobSystem::init(Queue* queue)
+    {
+        m_Queue = queue;
+        m_Device = GlobalData::getDevice();
+
+        VkSemaphoreTypeCreateInfo typeCI{};
+        typeCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeCI.pNext = nullptr;
+        typeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeCI.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreCI = Init::semaphoreCreateInfo();
+        semaphoreCI.pNext = &typeCI;
+
+        EOS_VK_CHECK(vkCreateSemaphore(m_Device, &semaphoreCI, nullptr, &m_Semaphore));
+    }
+
+    void ComputeJobSystem::cleanup()
+    {
+        waitIdle();
+
+        vkDestroySemaphore(m_Device, m_Semaphore, nullptr);
+
+        for (auto& [thread, pool] : m_Pools)
+            vkDestroyCommandPool(m_Device, pool->pool, nullptr);
+
+        m_Pools.clear();
+        m_InFlight.clear();
+    }
+
+    VkCommandBuffer ComputeJobSystem::begin()
+    {
+        VkCommandBuffer cmd;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            ThreadPool& pool = getPool();
+            if (pool.free.empty())
+                recycle(getCompletedValue());
+
+            if (!pool.free.empty())
+            {
+                cmd = pool.free.back();
+                pool.free.pop_back();
+
+                EOS_VK_CHECK(vkResetCommandBuffer(cmd, 0));
+            }
+            else
+            {
+                VkCommandBufferAllocateInfo cmdAI = Init::commandBufferAllocateInfo(
+                        pool.pool, 1);
+                EOS_VK_CHECK(vkAllocateCommandBuffers(m_Device, &cmdAI, &cmd));
+
+                m_Statistics.commandBuffers++;
+            }
+        }
+
+        VkCommandBufferBeginInfo cmdBeginInfo = Init::commandBufferBeginInfo(
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        EOS_VK_CHECK(vkBeginCommandBuffer(cmd, &cmdBeginInfo));
+
+        return cmd;
+    }
+
+    ComputeTicket ComputeJobSystem::submit(VkCommandBuffer cmd,
+            const std::vector<ComputeTicket>& dependencies)
+    {
+        EOS_VK_CHECK(vkEndCommandBuffer(cmd));
+
+        // Waiting on the latest dependency covers the earlier ones
+        uint64_t waitValue = 0;
+        for (const ComputeTicket& dependency : dependencies)
+            waitValue = std::max(waitValue, dependency.m_Value);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // Values have to be signalled in submission order
+        uint64_t signalValue = m_NextValue++;
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.pNext = nullptr;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+        VkSubmitInfo submit = Init::submitInfo(&cmd);
+        submit.pNext = &timelineInfo;
+        submit.signalSemaphoreCount = 1;
+        submit.pSignalSemaphores = &m_Semaphore;
+
+        if (waitValue != 0)
+        {
+            timelineInfo.waitSemaphoreValueCount = 1;
+            timelineInfo.pWaitSemaphoreValues = &waitValue;
+
+            submit.waitSemaphoreCount = 1;
+            submit.pWaitSemaphores = &m_Semaphore;
+            submit.pWaitDstStageMask = &waitStage;
+        }
+
+        EOS_VK_CHECK(m_Queue->submit(1, &submit, VK_NULL_HANDLE));
+
+        m_InFlight.push_back({ cmd, signalValue, &getPool() });
+        m_Statistics.submitted++;
+
+        ComputeTicket ticket;
+        ticket.m_System = this;
+        ticket.m_Value = signalValue;
+        return ticket;
+    }
+
+    ComputeTicket ComputeJobSystem::submit(std::function<void(VkCommandBuffer)>&& function,
+            const std::vector<ComputeTicket>& dependencies)
+    {
+        VkCommandBuffer cmd = begin();
+
+        function(cmd);
+
+        return submit(cmd, dependencies);
+    }
+
+    bool ComputeJobSystem::isComplete(uint64_t value)
+    {
+        return getCompletedValue() >= value;
+    }
+
+    bool ComputeJobSystem::wait(uint64_t value, uint64_t timeout)
+    {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.pNext = nullptr;
+        waitInfo.flags = 0;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_Semaphore;
+        waitInfo.pValues = &value;
+
+        VkResult result = vkWaitSemaphores(m_Device, &waitInfo, timeout);
+        if (result == VK_TIMEOUT)
+            return false;
+
+        EOS_VK_CHECK(result);
+        return true;
+    }
+
+    void ComputeJobSystem::waitIdle()
+    {
+        uint64_t lastValue;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            lastValue = m_NextValue - 1;
+        }
+
+        if (lastValue != 0)
+            wait(lastValue);
+
+        update();
+    }
+
+    uint64_t ComputeJobSystem::getCompletedValue()
+    {
+        uint64_t value;
+        EOS_VK_CHECK(vkGetSemaphoreCounterValue(m_Device, m_Semaphore, &value));
+
+        return value;
+    }
+
+    void ComputeJobSystem::update()
+    {
+        uint64_t completedValue = getCompletedValue();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        recycle(completedValue);
+    }
+
+    ComputeJobSystem::Statistics ComputeJobSystem::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Statistics statistics = m_Statistics;
+        statistics.inFlight = static_cast<uint32_t>(m_InFlight.size());
+        return statistics;
+    }
+
+    void ComputeJobSystem::recycle(uint64_t completedValue)
+    {
+        // Jobs finish in submission order
+        while (!m_InFlight.empty() && m_InFlight.front().value <= completedValue)
+        {
+            m_InFlight.front().pool->free.push_back(m_InFlight.front().cmd);
+            m_InFlight.pop_front();
+        }
+    }
+
+    ComputeJobSystem::ThreadPool& ComputeJobSystem::getPool()
+    {
+        std::unique_ptr<ThreadPool>& pool = m_Pools[std::this_thread::get_id()];
+        if (pool)
+            return *pool;
+
+        pool = std::make_unique<ThreadPool>();
+
+        VkCommandPoolCreateInfo commandPoolCI = Init::commandPoolCreateInfo(
+                m_Queue->family, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        EOS_VK_CHECK(vkCreateCommandPool(m_Device, &commandPoolCI, nullptr, &pool->pool));
+
+        return *pool;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Types.hpp"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    class ComputeJobSystem;
+
+    // Value the job system's timeline semaphore reaches once a job finishes
+    class EOS_API ComputeTicket
+    {
+    public:
+        ComputeTicket() {}
+
+        bool isValid() const { return m_System != nullptr; }
+        bool isReady() const;
+
+        // Returns false if the timeout (in nanoseconds) ran out first
+        bool wait(uint64_t timeout = UINT64_MAX) const;
+
+        uint64_t getValue() const { return m_Value; }
+    private:
+        friend class ComputeJobSystem;
+
+        ComputeJobSystem* m_System = nullptr;
+        uint64_t m_Value = 0;
+    };
+
+    // Submits compute work without waiting on it. Every submission signals a
+    // single timeline semaphore with an increasing value, so any number of
+    // jobs can be in flight and are only waited on through their tickets
+    class EOS_API ComputeJobSystem
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t submitted = 0;
+            uint32_t inFlight = 0;
+            uint32_t commandBuffers = 0;
+        };
+
+    public:
+        void init(Queue* queue);
+        void cleanup();
+
+        // A begun command buffer from the calling thread's pool, so threads
+        // can record at the same time
+        VkCommandBuffer begin();
+
+        // Ends and submits cmd, which must have come from begin on the same
+        // thread. The job starts once every dependency has finished
+        ComputeTicket submit(VkCommandBuffer cmd,
+                const std::vector<ComputeTicket>& dependencies = {});
+        ComputeTicket submit(std::function<void(VkCommandBuffer)>&& function,
+                const std::vector<ComputeTicket>& dependencies = {});
+
+        bool isComplete(uint64_t value);
+        bool wait(uint64_t value, uint64_t timeout = UINT64_MAX);
+        void waitIdle();
+
+        uint64_t getCompletedValue();
+
+        // Lets other queues wait on jobs through VkTimelineSemaphoreSubmitInfo
+        VkSemaphore getSemaphore() const { return m_Semaphore; }
+
+        // Returns the command buffers of finished jobs to the pool
+        void update();
+
+        Statistics getStatistics();
+    private:
+        // Only the owning thread records into the pool, the free list is
+        // guarded by m_Mutex as finished buffers are returned from any thread
+        struct ThreadPool
+        {
+            VkCommandPool pool;
+            std::vector<VkCommandBuffer> free;
+        };
+
+        struct InFlightJob
+        {
+            VkCommandBuffer cmd;
+            uint64_t value;
+            ThreadPool* pool;
+        };
+
+        std::unordered_map<std::thread::id, std::unique_ptr<ThreadPool>> m_Pools;
+        std::deque<InFlightJob> m_InFlight;
+
+        VkSemaphore m_Semaphore;
+        uint64_t m_NextValue = 1;
+
+        Statistics m_Statistics;
+
+        std::mutex m_Mutex;
+
+        Queue* m_Queue;
+        VkDevice m_Device;
+    private:
+        void recycle(uint64_t completedValue);
+        // The calling thread's pool, m_Mutex has to be held
+        ThreadPool& getPool();
+    };
+}
@@ -4,12 +4,11 @@
 #include <vulkan/vulkan_core.h>
 
 #include "Eos/Core/DeletionQueue.hpp"
+#include "Eos/Core/Hash.hpp"
 #include "Eos/Engine/Initializers.hpp"
 
 namespace Eos
 {
-    VkCommandPool ComputeShader::s_CommandPool;
-    VkFence ComputeShader::s_Fence;
     Queue* ComputeShader::s_Queue;
 
     ComputeShader::ComputeShader()
@@ -25,15 +24,6 @@ namespace Eos
     void ComputeShader::setup(Queue* queue)
     {
         s_Queue = queue;
-        initData();
-    }
-
-    void ComputeShader::cleanup()
-    {
-        vkResetCommandPool(GlobalData::getDevice(), s_CommandPool,
-                VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT);
-        vkDestroyFence(GlobalData::getDevice(), s_Fence, nullptr);
-        vkDestroyCommandPool(GlobalData::getDevice(), s_CommandPool, nullptr);
     }
 
     void ComputeShader::end(VkCommandBuffer& cmd)
@@ -52,11 +42,13 @@ namespace Eos
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
 
-        EOS_VK_CHECK(vkQueueSubmit(s_Queue->queue, 1, &submit, s_Fence));
-        EOS_VK_CHECK(vkWaitForFences(GlobalData::getDevice(), 1, &s_Fence,
+        VkFence fence = GlobalData::getFencePool().acquire();
+
+        EOS_VK_CHECK(s_Queue->submit(1, &submit, fence));
+        EOS_VK_CHECK(vkWaitForFences(GlobalData::getDevice(), 1, &fence,
                     true, std::uint64_t(-1)));
 
-        vkResetFences(GlobalData::getDevice(), 1, &s_Fence);
+        GlobalData::getFencePool().release(fence);
     }
 
     void ComputeShader::endAndWait(VkCommandBuffer& cmd)
@@ -67,7 +59,8 @@ namespace Eos
 
     void ComputeShader::resetCommandBuffer(VkCommandBuffer& cmd)
     {
-        vkResetCommandBuffer(cmd, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+        GlobalData::getCommandPools().release(cmd, s_Queue->family);
+        cmd = VK_NULL_HANDLE;
     }
 
     void ComputeShader::clearModule()
@@ -114,19 +107,26 @@ namespace Eos
         m_ShaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
         m_ShaderStage.module = m_Module;
         m_ShaderStage.pName = "main";
+        m_ShaderStage.pSpecializationInfo = m_Specialization.getInfo();
+
+        m_CodeHash = 0;
+        for (uint32_t word : buffer)
+            hashCombine(m_CodeHash, word);
+
+        m_Code = std::make_shared<const std::vector<uint32_t>>(std::move(buffer));
 
         m_CreatedModule = true;
     }
 
-    VkCommandBuffer ComputeShader::getCommandBuffer()
+    void ComputeShader::setSpecialization(const SpecializationConstants& constants)
     {
-        VkCommandBuffer cmd;
-
-        VkCommandBufferAllocateInfo cmdAI = Init::commandBufferAllocateInfo(
-                s_CommandPool, 1);
+        m_Specialization = constants;
+        m_ShaderStage.pSpecializationInfo = m_Specialization.getInfo();
+    }
 
-        EOS_VK_CHECK(vkAllocateCommandBuffers(GlobalData::getDevice(), &cmdAI,
-                    &cmd));
+    VkCommandBuffer ComputeShader::getCommandBuffer()
+    {
+        VkCommandBuffer cmd = GlobalData::getCommandPools().acquire(s_Queue->family);
 
         VkCommandBufferBeginInfo cmdBeginInfo{};
         cmdBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -138,18 +138,4 @@ namespace Eos
 
         return cmd;
     }
-
-    void ComputeShader::initData()
-    {
-        VkCommandPoolCreateInfo commandPoolCI = Init::commandPoolCreateInfo(
-                s_Queue->family, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
-
-        EOS_VK_CHECK(vkCreateCommandPool(GlobalData::getDevice(), &commandPoolCI,
-                    nullptr, &s_CommandPool));
-
-        VkFenceCreateInfo fenceCI = Init::fenceCreateInfo();
-
-        EOS_VK_CHECK(vkCreateFence(GlobalData::getDevice(), &fenceCI, nullptr,
-                    &s_Fence));
-    }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Eos/EosPCH.hpp"
+#include "Eos/Engine/Pipelines/SpecializationConstants.hpp"
+
 #include <vulkan/vulkan.hpp>
 
 namespace Eos
@@ -12,19 +14,26 @@ namespace Eos
         ~ComputeShader();
 
         static void setup(Queue* queue);
-        static void cleanup();
 
         static void end(VkCommandBuffer& cmd);
         static void wait(VkCommandBuffer& cmd);
         static void endAndWait(VkCommandBuffer& cmd);
 
+        // Returns the buffer to the engine's command pools
         static void resetCommandBuffer(VkCommandBuffer& cmd);
 
         void clearModule();
         void addShaderModule(const char* path);
 
+        void setSpecialization(const SpecializationConstants& constants);
+        const SpecializationConstants& getSpecialization() const { return m_Specialization; }
+
+        // Identifies the SPIR-V, module handles can be reused once destroyed.
+        // The hash only buckets, pipelines compare the code itself
+        size_t getCodeHash() const { return m_CodeHash; }
+        const std::shared_ptr<const std::vector<uint32_t>>& getCode() const { return m_Code; }
+
         static VkCommandBuffer getCommandBuffer();
-        static VkFence getFence() { return s_Fence; }
         static Queue* getQueue() { return s_Queue; }
 
         VkPipelineShaderStageCreateInfo& getShaderStage() { return m_ShaderStage; }
@@ -33,13 +42,12 @@ namespace Eos
         VkPipelineShaderStageCreateInfo m_ShaderStage;
         VkShaderModule m_Module;
 
-        bool m_CreatedModule = false;
+        SpecializationConstants m_Specialization;
+        size_t m_CodeHash = 0;
+        std::shared_ptr<const std::vector<uint32_t>> m_Code;
 
-        static VkCommandPool s_CommandPool;
-        static VkFence s_Fence;
+        bool m_CreatedModule = false;
 
         static Queue* s_Queue;
-
-        static void initData();
     };
 }
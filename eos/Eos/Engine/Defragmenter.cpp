@@ -0,0 +1,462 @@
+#include "Defragmenter.hpp"
+
+#include "Eos/Engine/GlobalData.hpp"
+
+#include <algorithm>
+
+namespace Eos
+{
+    void Defragmenter::init(VkDevice device, VmaAllocator allocator, uint32_t framesInFlight)
+    {
+        m_Device = device;
+        m_Allocator = allocator;
+        m_FramesInFlight = framesInFlight;
+    }
+
+    void Defragmenter::cleanup()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_PassOpen)
+            endPass();
+
+        end();
+
+        m_Resources.clear();
+    }
+
+    void Defragmenter::registerBuffer(Buffer& buffer, DefragmentationMovedFunction onMoved)
+    {
+        VkBufferUsageFlags required = VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        if ((buffer.usage & required) != required)
+        {
+            EOS_CORE_LOG_WARN("Buffers need transfer source and destination usage to be defragmented");
+            return;
+        }
+
+        if (isHostVisible(buffer.allocation))
+        {
+            EOS_CORE_LOG_WARN("Host visible buffers can not be defragmented");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Resources[buffer.allocation] = { &buffer, nullptr, onMoved };
+    }
+
+    void Defragmenter::registerTexture(Texture2D& texture, DefragmentationMovedFunction onMoved)
+    {
+        VkImageUsageFlags required = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        if ((texture.usage & required) != required)
+        {
+            EOS_CORE_LOG_WARN("Textures need transfer source and destination usage to be defragmented");
+            return;
+        }
+
+        if (isHostVisible(texture.allocation))
+        {
+            EOS_CORE_LOG_WARN("Host visible textures can not be defragmented");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Resources[texture.allocation] = { nullptr, &texture, onMoved };
+    }
+
+    void Defragmenter::unregister(VmaAllocation allocation)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Resources.erase(allocation);
+    }
+
+    void Defragmenter::begin(VkDeviceSize maxBytesPerPass, uint32_t maxAllocationsPerPass)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        start(maxBytesPerPass, maxAllocationsPerPass);
+    }
+
+    void Defragmenter::start(VkDeviceSize maxBytesPerPass, uint32_t maxAllocationsPerPass)
+    {
+        if (isRunning())
+            return;
+
+        VmaDefragmentationInfo info{};
+        info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FAST_BIT;
+        info.maxBytesPerPass = maxBytesPerPass;
+        info.maxAllocationsPerPass = maxAllocationsPerPass;
+
+        EOS_VK_CHECK(vmaBeginDefragmentation(m_Allocator, &info, &m_Context));
+
+        m_Statistics.runs++;
+    }
+
+    void Defragmenter::update(VkCommandBuffer cmd, uint64_t frame)
+    {
+        std::vector<DefragmentationMovedFunction> callbacks;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (!isRunning())
+            {
+                if (m_AutomaticThreshold <= 0.0f || frame % s_AutomaticCheckInterval != 0 ||
+                        !shouldDefragment())
+                    return;
+
+                start(s_DefaultBytesPerPass, s_DefaultAllocationsPerPass);
+            }
+
+            // The copies were recorded into that frame's command buffer, so
+            // they are done once its slot comes around again
+            if (m_PassOpen)
+            {
+                if (frame - m_PassFrame < m_FramesInFlight)
+                    return;
+
+                endPass();
+
+                if (!isRunning())
+                    return;
+            }
+
+            beginPass(cmd, frame, callbacks);
+        }
+
+        for (DefragmentationMovedFunction& callback : callbacks)
+            callback();
+    }
+
+    void Defragmenter::destroyBuffer(VkBuffer buffer, VmaAllocation allocation)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Resources.erase(allocation);
+
+        if (releaseFromPass(allocation))
+            vkDestroyBuffer(m_Device, buffer, nullptr);
+        else
+            vmaDestroyBuffer(m_Allocator, buffer, allocation);
+    }
+
+    void Defragmenter::destroyImage(VkImage image, VmaAllocation allocation)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Resources.erase(allocation);
+
+        if (releaseFromPass(allocation))
+            vkDestroyImage(m_Device, image, nullptr);
+        else
+            vmaDestroyImage(m_Allocator, image, allocation);
+    }
+
+    Defragmenter::Statistics Defragmenter::getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Statistics;
+    }
+
+    bool Defragmenter::beginPass(VkCommandBuffer cmd, uint64_t frame,
+            std::vector<DefragmentationMovedFunction>& callbacks)
+    {
+        VkResult result = vmaBeginDefragmentationPass(m_Allocator, m_Context, &m_Pass);
+        if (result == VK_SUCCESS)
+        {
+            // Nothing left to move
+            end();
+            return false;
+        }
+
+        m_PassOpen = true;
+        m_PassFrame = frame;
+        m_Statistics.passes++;
+
+        std::vector<MovedResource> moved;
+        for (uint32_t i = 0; i < m_Pass.moveCount; i++)
+        {
+            VmaDefragmentationMove& move = m_Pass.pMoves[i];
+
+            // Mapped after being registered, the CPU could write to it mid pass
+            auto it = m_Resources.find(move.srcAllocation);
+            if (it == m_Resources.end() || isHostVisible(move.srcAllocation))
+            {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            MovedResource resource;
+            resource.resource = it->second;
+
+            if (Buffer* buffer = resource.resource.buffer)
+            {
+                VkBufferCreateInfo info{};
+                info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                info.pNext = nullptr;
+                info.size = buffer->size;
+                info.usage = buffer->usage;
+                info.sharingMode = buffer->sharingMode;
+                info.queueFamilyIndexCount = static_cast<uint32_t>(buffer->queueFamilies.size());
+                info.pQueueFamilyIndices = buffer->queueFamilies.data();
+
+                EOS_VK_CHECK(vkCreateBuffer(m_Device, &info, nullptr, &resource.newBuffer));
+                EOS_VK_CHECK(vmaBindBufferMemory(m_Allocator, move.dstTmpAllocation,
+                            resource.newBuffer));
+            }
+            else
+            {
+                Texture2D* texture = resource.resource.texture;
+
+                VkImageCreateInfo info{};
+                info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                info.pNext = nullptr;
+                info.imageType = VK_IMAGE_TYPE_2D;
+                info.format = texture->format;
+                info.extent = texture->extent;
+                info.mipLevels = texture->mipLevels;
+                info.arrayLayers = texture->arrayLayers;
+                info.samples = VK_SAMPLE_COUNT_1_BIT;
+                info.tiling = VK_IMAGE_TILING_OPTIMAL;
+                info.usage = texture->usage;
+
+                EOS_VK_CHECK(vkCreateImage(m_Device, &info, nullptr, &resource.newImage));
+                EOS_VK_CHECK(vmaBindImageMemory(m_Allocator, move.dstTmpAllocation,
+                            resource.newImage));
+            }
+
+            moved.push_back(resource);
+        }
+
+        // Only unregistered allocations are left, further passes would not
+        // free anything
+        if (moved.empty())
+        {
+            endPass();
+            end();
+            return false;
+        }
+
+        // Earlier frames on the queue may still be writing to the old resources
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        for (MovedResource& resource : moved)
+        {
+            if (resource.resource.buffer)
+                recordBufferMove(cmd, *resource.resource.buffer, resource.newBuffer);
+            else
+                recordImageMove(cmd, *resource.resource.texture, resource.newImage);
+        }
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        for (MovedResource& resource : moved)
+        {
+            if (Buffer* buffer = resource.resource.buffer)
+            {
+                RetiredHandles retired;
+                retired.buffer = buffer->buffer;
+                m_Retired.push_back(retired);
+
+                GlobalData::getDescriptorSetCache().invalidate(buffer->buffer);
+                buffer->buffer = resource.newBuffer;
+            }
+            else
+            {
+                Texture2D* texture = resource.resource.texture;
+
+                RetiredHandles retired;
+                retired.image = texture->image;
+                retired.imageView = texture->imageView;
+                m_Retired.push_back(retired);
+
+                GlobalData::getDescriptorSetCache().invalidate(texture->imageView);
+                texture->image = resource.newImage;
+                texture->createImageView(texture->viewFormat, texture->aspectFlags);
+            }
+
+            if (resource.resource.onMoved)
+                callbacks.push_back(resource.resource.onMoved);
+        }
+
+        return true;
+    }
+
+    void Defragmenter::endPass()
+    {
+        for (RetiredHandles& retired : m_Retired)
+        {
+            if (retired.imageView != VK_NULL_HANDLE)
+                vkDestroyImageView(m_Device, retired.imageView, nullptr);
+            if (retired.image != VK_NULL_HANDLE)
+                vkDestroyImage(m_Device, retired.image, nullptr);
+            if (retired.buffer != VK_NULL_HANDLE)
+                vkDestroyBuffer(m_Device, retired.buffer, nullptr);
+        }
+        m_Retired.clear();
+
+        VkResult result = vmaEndDefragmentationPass(m_Allocator, m_Context, &m_Pass);
+        m_PassOpen = false;
+
+        if (result == VK_SUCCESS)
+            end();
+    }
+
+    void Defragmenter::end()
+    {
+        if (!isRunning())
+            return;
+
+        VmaDefragmentationStats stats;
+        vmaEndDefragmentation(m_Allocator, m_Context, &stats);
+        m_Context = VK_NULL_HANDLE;
+
+        m_Statistics.bytesMoved += stats.bytesMoved;
+        m_Statistics.allocationsMoved += stats.allocationsMoved;
+        m_Statistics.blocksFreed += stats.deviceMemoryBlocksFreed;
+
+        EOS_CORE_LOG_INFO("Defragmentation moved {} allocations and freed {} blocks",
+                stats.allocationsMoved, stats.deviceMemoryBlocksFreed);
+    }
+
+    bool Defragmenter::releaseFromPass(VmaAllocation allocation)
+    {
+        if (!m_PassOpen)
+            return false;
+
+        for (uint32_t i = 0; i < m_Pass.moveCount; i++)
+        {
+            VmaDefragmentationMove& move = m_Pass.pMoves[i];
+            if (move.srcAllocation == allocation)
+            {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Defragmenter::recordBufferMove(VkCommandBuffer cmd, Buffer& buffer, VkBuffer newBuffer)
+    {
+        VkBufferCopy copy;
+        copy.srcOffset = 0;
+        copy.dstOffset = 0;
+        copy.size = buffer.size;
+
+        vkCmdCopyBuffer(cmd, buffer.buffer, newBuffer, 1, &copy);
+    }
+
+    void Defragmenter::recordImageMove(VkCommandBuffer cmd, Texture2D& texture, VkImage newImage)
+    {
+        // Blocks of levels and layers sharing a tracked layout, so each can
+        // be returned to where it was after the copy
+        std::vector<ImageState::Range> ranges = texture.imageState.getRanges({
+                texture.aspectFlags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS });
+
+        std::vector<VkImageMemoryBarrier> barriers;
+        std::vector<VkImageCopy> regions;
+
+        for (const ImageState::Range& range : ranges)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange = range.range;
+
+            barrier.image = texture.image;
+            barrier.oldLayout = range.access.layout;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barriers.push_back(barrier);
+
+            barrier.image = newImage;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barriers.push_back(barrier);
+
+            for (uint32_t level = range.range.baseMipLevel;
+                    level < range.range.baseMipLevel + range.range.levelCount; level++)
+            {
+                VkImageCopy region{};
+                region.srcSubresource.aspectMask = texture.aspectFlags;
+                region.srcSubresource.mipLevel = level;
+                region.srcSubresource.baseArrayLayer = range.range.baseArrayLayer;
+                region.srcSubresource.layerCount = range.range.layerCount;
+                region.dstSubresource = region.srcSubresource;
+                region.extent.width = std::max(texture.extent.width >> level, 1u);
+                region.extent.height = std::max(texture.extent.height >> level, 1u);
+                region.extent.depth = 1;
+                regions.push_back(region);
+            }
+        }
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                barriers.size(), barriers.data());
+
+        vkCmdCopyImage(cmd, texture.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                newImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+
+        // Everything goes back to the layout the texture is tracking. Ranges
+        // tracked as undefined can be left as they are
+        barriers.clear();
+        for (const ImageState::Range& range : ranges)
+        {
+            if (range.access.layout == VK_IMAGE_LAYOUT_UNDEFINED)
+                continue;
+
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange = range.range;
+            barrier.image = newImage;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = range.access.layout;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            barriers.push_back(barrier);
+        }
+
+        if (!barriers.empty())
+        {
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr,
+                    barriers.size(), barriers.data());
+        }
+    }
+
+    bool Defragmenter::isHostVisible(VmaAllocation allocation)
+    {
+        VkMemoryPropertyFlags flags;
+        vmaGetAllocationMemoryProperties(m_Allocator, allocation, &flags);
+
+        return (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+    }
+
+    bool Defragmenter::shouldDefragment()
+    {
+        VmaTotalStatistics stats;
+        vmaCalculateStatistics(m_Allocator, &stats);
+
+        const VmaStatistics& total = stats.total.statistics;
+        if (total.blockCount < 2 || total.blockBytes == 0)
+            return false;
+
+        VkDeviceSize unused = total.blockBytes - total.allocationBytes;
+        return static_cast<float>(unused) / total.blockBytes > m_AutomaticThreshold;
+    }
+}
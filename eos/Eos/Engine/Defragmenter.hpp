@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/Texture.hpp"
+
+#include <functional>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+namespace Eos
+{
+    using DefragmentationMovedFunction = std::function<void()>;
+
+    // Compacts device memory with VMA defragmentation, a little every frame.
+    // Only registered buffers and textures are moved. Their handles are
+    // replaced in place, so registered objects must not move in memory and
+    // descriptor sets holding them need to be rewritten from the callback.
+    // Host visible allocations are never moved, as CPU writes made while
+    // their copy is in flight would be lost
+    class EOS_API Defragmenter
+    {
+    public:
+        struct Statistics
+        {
+            VkDeviceSize bytesMoved = 0;
+            uint32_t allocationsMoved = 0;
+            uint32_t blocksFreed = 0;
+            uint32_t passes = 0;
+            uint32_t runs = 0;
+        };
+
+    public:
+        void init(VkDevice device, VmaAllocator allocator, uint32_t framesInFlight);
+        void cleanup();
+
+        void registerBuffer(Buffer& buffer, DefragmentationMovedFunction onMoved = nullptr);
+        void registerTexture(Texture2D& texture, DefragmentationMovedFunction onMoved = nullptr);
+        void unregister(VmaAllocation allocation);
+
+        // Starts a run if one is not already active
+        void begin(VkDeviceSize maxBytesPerPass = s_DefaultBytesPerPass,
+                uint32_t maxAllocationsPerPass = s_DefaultAllocationsPerPass);
+        bool isRunning() const { return m_Context != VK_NULL_HANDLE; }
+
+        // Starts a run whenever the unused fraction of allocated blocks goes
+        // above threshold. A threshold of 0 disables this
+        void setAutomatic(float threshold) { m_AutomaticThreshold = threshold; }
+
+        // Records the copies of the next pass into cmd, which has to run before
+        // anything else in the frame uses the registered resources
+        void update(VkCommandBuffer cmd, uint64_t frame);
+
+        // Resources have to be destroyed through these while a run is active,
+        // allocations that are part of the open pass are freed by VMA instead.
+        // Safe to call from any thread
+        void destroyBuffer(VkBuffer buffer, VmaAllocation allocation);
+        void destroyImage(VkImage image, VmaAllocation allocation);
+
+        Statistics getStatistics() const;
+    private:
+        struct Resource
+        {
+            Buffer* buffer = nullptr;
+            Texture2D* texture = nullptr;
+            DefragmentationMovedFunction onMoved;
+        };
+
+        struct MovedResource
+        {
+            Resource resource;
+            VkBuffer newBuffer = VK_NULL_HANDLE;
+            VkImage newImage = VK_NULL_HANDLE;
+        };
+
+        struct RetiredHandles
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView imageView = VK_NULL_HANDLE;
+        };
+
+        static const uint64_t s_AutomaticCheckInterval = 600;
+        static const VkDeviceSize s_DefaultBytesPerPass = 16 * 1024 * 1024;
+        static const uint32_t s_DefaultAllocationsPerPass = 64;
+
+        std::unordered_map<VmaAllocation, Resource> m_Resources;
+
+        VmaDefragmentationContext m_Context = VK_NULL_HANDLE;
+        VmaDefragmentationPassMoveInfo m_Pass{};
+        bool m_PassOpen = false;
+        uint64_t m_PassFrame = 0;
+
+        // Old handles are kept alive until every frame using them has finished
+        std::vector<RetiredHandles> m_Retired;
+
+        float m_AutomaticThreshold = 0.0f;
+
+        Statistics m_Statistics;
+
+        // Resources are destroyed from loader threads
+        mutable std::mutex m_Mutex;
+
+        VkDevice m_Device;
+        VmaAllocator m_Allocator;
+        uint32_t m_FramesInFlight = 1;
+    private:
+        void start(VkDeviceSize maxBytesPerPass, uint32_t maxAllocationsPerPass);
+
+        // The callbacks of moved resources are returned to be called without
+        // the lock held
+        bool beginPass(VkCommandBuffer cmd, uint64_t frame,
+                std::vector<DefragmentationMovedFunction>& callbacks);
+        void endPass();
+        void end();
+
+        bool releaseFromPass(VmaAllocation allocation);
+
+        void recordBufferMove(VkCommandBuffer cmd, Buffer& buffer, VkBuffer newBuffer);
+        void recordImageMove(VkCommandBuffer cmd, Texture2D& texture, VkImage newImage);
+
+        bool isHostVisible(VmaAllocation allocation);
+        bool shouldDefragment();
+    };
+}
@@ -1,27 +1,56 @@
 #include "DescriptorAllocator.hpp"
 
+#include "Eos/Engine/GlobalData.hpp"
+
+#include <algorithm>
+
 namespace Eos
 {
-    void DescriptorAllocator::init(VkDevice newDevice)
+    void DescriptorAllocator::init(VkDevice newDevice, uint32_t setsPerPool, bool adaptive,
+            uint32_t framesInFlight)
     {
         device = newDevice;
+        m_SetsPerPool = setsPerPool;
+        m_Adaptive = adaptive;
+        m_FramesInFlight = framesInFlight;
+
+        m_Statistics.setsPerPool = m_SetsPerPool;
     }
 
     void DescriptorAllocator::cleanup()
     {
         for (auto pool : m_FreePools)
         {
+            GlobalData::getMemoryStats().untrack(reinterpret_cast<uint64_t>(pool));
             vkDestroyDescriptorPool(device, pool, nullptr);
         }
 
         for (auto pool : m_UsedPools)
         {
+            GlobalData::getMemoryStats().untrack(reinterpret_cast<uint64_t>(pool));
             vkDestroyDescriptorPool(device, pool, nullptr);
         }
+
+        m_FreePools.clear();
+        m_UsedPools.clear();
+        m_CurrentPool = VK_NULL_HANDLE;
+
+        m_RetiredSets.clear();
+        m_RecycledSets.clear();
     }
 
     bool DescriptorAllocator::allocate(VkDescriptorSet* set, VkDescriptorSetLayout layout)
     {
+        auto recycled = m_RecycledSets.find(layout);
+        if (recycled != m_RecycledSets.end() && !recycled->second.empty())
+        {
+            *set = recycled->second.back();
+            recycled->second.pop_back();
+
+            m_Statistics.setsRecycled++;
+            return true;
+        }
+
         if (m_CurrentPool == VK_NULL_HANDLE)
         {
             m_CurrentPool = grabPool();
@@ -41,6 +70,8 @@ namespace Eos
         switch (allocResult)
         {
         case VK_SUCCESS:
+            m_SetsSinceReset++;
+            m_Statistics.setsAllocated++;
             return true;
         case VK_ERROR_FRAGMENTED_POOL:
         case VK_ERROR_OUT_OF_POOL_MEMORY:
@@ -54,8 +85,16 @@ namespace Eos
         {
             m_CurrentPool = grabPool();
             m_UsedPools.push_back(m_CurrentPool);
+
+            allocInfo.descriptorPool = m_CurrentPool;
             allocResult = vkAllocateDescriptorSets(device, &allocInfo, set);
-            return (allocResult == VK_SUCCESS);
+
+            if (allocResult != VK_SUCCESS)
+                return false;
+
+            m_SetsSinceReset++;
+            m_Statistics.setsAllocated++;
+            return true;
         }
 
         return false;
@@ -69,8 +108,53 @@ namespace Eos
             m_FreePools.push_back(pool);
         }
 
+        // Grow the pool size to cover the sets used during the last cycle, so
+        // that in the steady state each reset cycle only touches a single pool
+        if (m_Adaptive && m_UsedPools.size() > 1 && m_SetsPerPool < s_MaxSetsPerPool)
+        {
+            uint32_t newSize = m_SetsPerPool;
+            while (newSize < m_SetsSinceReset && newSize < s_MaxSetsPerPool)
+                newSize *= 2;
+
+            m_SetsPerPool = std::min(newSize, s_MaxSetsPerPool);
+
+            for (auto pool : m_FreePools)
+            {
+                GlobalData::getMemoryStats().untrack(reinterpret_cast<uint64_t>(pool));
+                vkDestroyDescriptorPool(device, pool, nullptr);
+            }
+            m_FreePools.clear();
+        }
+
         m_UsedPools.clear();
         m_CurrentPool = VK_NULL_HANDLE;
+        m_SetsSinceReset = 0;
+
+        // Every set came from one of the reset pools
+        m_RetiredSets.clear();
+        m_RecycledSets.clear();
+
+        m_Statistics.poolsInUse = 0;
+        m_Statistics.setsPerPool = m_SetsPerPool;
+        m_Statistics.resets++;
+    }
+
+    void DescriptorAllocator::release(VkDescriptorSet set, VkDescriptorSetLayout layout)
+    {
+        m_RetiredSets.push_back({ set, layout, m_Frame });
+    }
+
+    void DescriptorAllocator::nextFrame(uint64_t frame)
+    {
+        m_Frame = frame;
+
+        while (!m_RetiredSets.empty() &&
+                m_RetiredSets.front().frame + m_FramesInFlight <= frame)
+        {
+            RetiredSet& retired = m_RetiredSets.front();
+            m_RecycledSets[retired.layout].push_back(retired.set);
+            m_RetiredSets.pop_front();
+        }
     }
 
     VkDescriptorPool DescriptorAllocator::createPool(VkDevice device, const PoolSizes& poolSizes,
@@ -91,13 +175,19 @@ namespace Eos
         poolInfo.pPoolSizes = sizes.data();
 
         VkDescriptorPool descriptorPool;
-        vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool);
+        EOS_VK_CHECK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool));
+
+        // Drivers do not report pool sizes, so pools are only counted
+        GlobalData::getMemoryStats().track(MemoryCategory::DescriptorPool,
+                reinterpret_cast<uint64_t>(descriptorPool), 0);
 
         return descriptorPool;
     }
 
     VkDescriptorPool DescriptorAllocator::grabPool()
     {
+        m_Statistics.poolsInUse++;
+
         if (m_FreePools.size() > 0)
         {
             VkDescriptorPool pool = m_FreePools.back();
@@ -106,7 +196,8 @@ namespace Eos
         }
         else
         {
-            return createPool(device, m_DescriptorSizes, 1000, 0);
+            m_Statistics.poolsCreated++;
+            return createPool(device, m_DescriptorSizes, m_SetsPerPool, 0);
         }
     }
 }
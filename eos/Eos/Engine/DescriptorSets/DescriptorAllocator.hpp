@@ -4,6 +4,8 @@
 
 #include "Eos/EosPCH.hpp"
 
+#include <deque>
+
 #include <vulkan/vulkan.h>
 
 namespace Eos
@@ -29,22 +31,61 @@ namespace Eos
             };
         };
 
+        struct Statistics
+        {
+            uint32_t poolsCreated = 0;
+            uint32_t poolsInUse = 0;
+            uint32_t setsPerPool = 0;
+            uint32_t setsAllocated = 0;
+            uint32_t setsRecycled = 0;
+            uint32_t resets = 0;
+        };
+
         VkDevice device;
     public:
-        void init(VkDevice newDevice);
+        void init(VkDevice newDevice, uint32_t setsPerPool = 1000, bool adaptive = false,
+                uint32_t framesInFlight = 1);
         void cleanup();
 
         bool allocate(VkDescriptorSet* set, VkDescriptorSetLayout layout);
         void resetPools();
 
+        // Hands a set back once the frames that may still use it are complete.
+        // Later allocations with the same layout reuse it
+        void release(VkDescriptorSet set, VkDescriptorSetLayout layout);
+        void nextFrame(uint64_t frame);
+
+        const Statistics& getStatistics() const { return m_Statistics; }
+
         static VkDescriptorPool createPool(VkDevice device, const PoolSizes& poolSizes,
                 int count, VkDescriptorPoolCreateFlags flags);
     private:
+        static constexpr uint32_t s_MaxSetsPerPool = 4096;
+
+        struct RetiredSet
+        {
+            VkDescriptorSet set;
+            VkDescriptorSetLayout layout;
+            uint64_t frame;
+        };
+
         VkDescriptorPool m_CurrentPool{VK_NULL_HANDLE};
         PoolSizes m_DescriptorSizes;
 
         std::vector<VkDescriptorPool> m_UsedPools;
         std::vector<VkDescriptorPool> m_FreePools;
+
+        uint32_t m_SetsPerPool = 1000;
+        bool m_Adaptive = false;
+
+        uint32_t m_SetsSinceReset = 0;
+
+        std::deque<RetiredSet> m_RetiredSets;
+        std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>> m_RecycledSets;
+        uint32_t m_FramesInFlight = 1;
+        uint64_t m_Frame = 0;
+
+        Statistics m_Statistics;
     private:
         VkDescriptorPool grabPool();
     };
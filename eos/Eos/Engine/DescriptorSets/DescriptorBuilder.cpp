@@ -1,37 +1,56 @@
 #include "DescriptorBuilder.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Eos
 {
+    bool DescriptorBuilder::s_PushDescriptorsSupported = false;
+    PFN_vkCmdPushDescriptorSetKHR DescriptorBuilder::s_CmdPushDescriptorSet = nullptr;
+
     DescriptorBuilder DescriptorBuilder::begin(DescriptorLayoutCache* layoutCache,
-            DescriptorAllocator* allocator)
+            DescriptorAllocator* allocator, DescriptorSetCache* setCache)
     {
         DescriptorBuilder builder;
         builder.m_Cache = layoutCache;
         builder.m_Alloc = allocator;
+        builder.m_SetCache = setCache;
 
         return builder;
     }
 
+    void DescriptorBuilder::setupPushDescriptors(VkDevice device, bool supported)
+    {
+        s_PushDescriptorsSupported = false;
+        s_CmdPushDescriptorSet = nullptr;
+
+        if (!supported)
+            return;
+
+        s_CmdPushDescriptorSet = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+                vkGetDeviceProcAddr(device, "vkCmdPushDescriptorSetKHR"));
+
+        s_PushDescriptorsSupported = s_CmdPushDescriptorSet != nullptr;
+    }
+
+    DescriptorBuilder& DescriptorBuilder::setPushDescriptor()
+    {
+        m_PushDescriptor = true;
+        return *this;
+    }
+
     DescriptorBuilder& DescriptorBuilder::bindBuffer(uint32_t binding,
             VkDescriptorBufferInfo* bufferInfo, VkDescriptorType type,
             VkShaderStageFlags stageFlags)
     {
-        VkDescriptorSetLayoutBinding newBinding{};
-        newBinding.descriptorCount = 1;
-        newBinding.descriptorType = type;
-        newBinding.pImmutableSamplers = nullptr;
-        newBinding.stageFlags = stageFlags;
-        newBinding.binding = binding;
+        addBinding(binding, type, stageFlags);
 
-        m_Bindings.push_back(newBinding);
-
-        VkWriteDescriptorSet newWrite{};
-        newWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        newWrite.pNext = nullptr;
-        newWrite.descriptorCount = 1;
-        newWrite.descriptorType = type;
-        newWrite.pBufferInfo = bufferInfo;
-        newWrite.dstBinding = binding;
+        DescriptorWrite newWrite;
+        std::memset(&newWrite, 0, sizeof(DescriptorWrite));
+        newWrite.binding = binding;
+        newWrite.type = type;
+        if (bufferInfo)
+            newWrite.bufferInfo = *bufferInfo;
 
         m_Writes.push_back(newWrite);
 
@@ -41,6 +60,95 @@ namespace Eos
     DescriptorBuilder& DescriptorBuilder::bindImage(uint32_t binding,
             VkDescriptorImageInfo* imageInfo, VkDescriptorType type,
             VkShaderStageFlags stageFlags)
+    {
+        addBinding(binding, type, stageFlags);
+
+        DescriptorWrite newWrite;
+        std::memset(&newWrite, 0, sizeof(DescriptorWrite));
+        newWrite.binding = binding;
+        newWrite.type = type;
+        if (imageInfo)
+            newWrite.imageInfo = *imageInfo;
+
+        m_Writes.push_back(newWrite);
+        return *this;
+    }
+
+    bool DescriptorBuilder::build(VkDescriptorSet& set, VkDescriptorSetLayout& layout)
+    {
+        if (m_PushDescriptor)
+        {
+            EOS_CORE_LOG_ERROR("Descriptor sets can not be built from a push descriptor layout");
+            return false;
+        }
+
+        layout = buildLayout();
+
+        DescriptorSetCache::DescriptorSetInfo setInfo;
+        if (m_SetCache)
+        {
+            setInfo.layout = layout;
+            setInfo.writes = m_Writes;
+
+            std::optional<VkDescriptorSet> cached = m_SetCache->find(setInfo);
+            if (cached.has_value())
+            {
+                set = cached.value();
+                return true;
+            }
+        }
+
+        bool success = m_Alloc->allocate(&set, layout);
+        if (!success) { return false; }
+
+        writeSet(set, layout);
+
+        if (m_SetCache)
+            m_SetCache->insert(setInfo, set);
+
+        return true;
+    }
+
+    bool DescriptorBuilder::build(VkDescriptorSet& set)
+    {
+        VkDescriptorSetLayout layout;
+        return build(set, layout);
+    }
+
+    bool DescriptorBuilder::update(VkDescriptorSet& set, bool inFlight)
+    {
+        if (m_PushDescriptor)
+        {
+            EOS_CORE_LOG_ERROR("Descriptor sets can not be updated from a push descriptor layout");
+            return false;
+        }
+
+        VkDescriptorSetLayout layout = buildLayout();
+
+        bool shared = m_SetCache && m_SetCache->contains(set);
+        if (set != VK_NULL_HANDLE && !shared && !inFlight)
+        {
+            writeSet(set, layout);
+            return true;
+        }
+
+        // The new set is kept out of the set cache, so later updates can
+        // write it in place
+        VkDescriptorSet newSet;
+        if (!m_Alloc->allocate(&newSet, layout))
+            return false;
+
+        writeSet(newSet, layout);
+
+        if (set != VK_NULL_HANDLE && !shared)
+            m_Alloc->release(set, layout);
+
+        set = newSet;
+        return true;
+    }
+
+    void DescriptorBuilder::addBinding(uint32_t binding, VkDescriptorType type,
+            VkShaderStageFlags stageFlags)
     {
         VkDescriptorSetLayoutBinding newBinding{};
         newBinding.descriptorCount = 1;
@@ -50,45 +158,99 @@ namespace Eos
         newBinding.binding = binding;
 
         m_Bindings.push_back(newBinding);
-
-        VkWriteDescriptorSet newWrite{};
-        newWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        newWrite.pNext = nullptr;
-        newWrite.descriptorCount = 1;
-        newWrite.descriptorType = type;
-        newWrite.pImageInfo = imageInfo;
-        newWrite.dstBinding = binding;
-
-        m_Writes.push_back(newWrite);
-        return *this;
     }
 
-    bool DescriptorBuilder::build(VkDescriptorSet& set, VkDescriptorSetLayout& layout)
+    VkDescriptorSetLayout DescriptorBuilder::buildLayout()
     {
+        // Writes are kept in binding order so that the template entries and
+        // cache keys do not depend on the order resources were bound in
+        std::sort(m_Bindings.begin(), m_Bindings.end(),
+                [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b)
+                {
+                    return a.binding < b.binding;
+                });
+
+        std::sort(m_Writes.begin(), m_Writes.end(),
+                [](const DescriptorWrite& a, const DescriptorWrite& b)
+                {
+                    return a.binding < b.binding;
+                });
+
         VkDescriptorSetLayoutCreateInfo layoutInfo{};
         layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
         layoutInfo.pNext = nullptr;
         layoutInfo.pBindings = m_Bindings.data();
         layoutInfo.bindingCount = m_Bindings.size();
 
-        layout = m_Cache->createDescriptorLayout(&layoutInfo);
+        if (m_PushDescriptor)
+            layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
 
-        bool success = m_Alloc->allocate(&set, layout);
-        if (!success) { return false; }
+        return m_Cache->createDescriptorLayout(&layoutInfo);
+    }
+
+    void DescriptorBuilder::writeSet(VkDescriptorSet set, VkDescriptorSetLayout layout)
+    {
+        std::vector<VkDescriptorUpdateTemplateEntry> entries;
+        entries.reserve(m_Writes.size());
 
-        for (VkWriteDescriptorSet& w : m_Writes)
+        for (size_t i = 0; i < m_Writes.size(); i++)
         {
-            w.dstSet = set;
+            bool isBuffer = isBufferType(m_Writes[i].type);
+
+            VkDescriptorUpdateTemplateEntry entry{};
+            entry.dstBinding = m_Writes[i].binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = 1;
+            entry.descriptorType = m_Writes[i].type;
+            entry.offset = i * sizeof(DescriptorWrite) + (isBuffer ?
+                    offsetof(DescriptorWrite, bufferInfo) : offsetof(DescriptorWrite, imageInfo));
+            entry.stride = sizeof(DescriptorWrite);
+
+            entries.push_back(entry);
         }
 
-        vkUpdateDescriptorSets(m_Alloc->device, m_Writes.size(), m_Writes.data(), 0, nullptr);
+        VkDescriptorUpdateTemplate updateTemplate = m_Cache->getUpdateTemplate(layout, entries);
+        vkUpdateDescriptorSetWithTemplate(m_Alloc->device, set, updateTemplate, m_Writes.data());
+    }
 
-        return true;
+    void DescriptorBuilder::push(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint,
+            VkPipelineLayout pipelineLayout, uint32_t set)
+    {
+        if (!s_PushDescriptorsSupported)
+        {
+            EOS_CORE_LOG_ERROR("Push descriptors are not supported by this device");
+            return;
+        }
+
+        std::vector<VkWriteDescriptorSet> writes;
+        writes.reserve(m_Writes.size());
+
+        for (const DescriptorWrite& w : m_Writes)
+        {
+            VkWriteDescriptorSet newWrite{};
+            newWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            newWrite.pNext = nullptr;
+            newWrite.dstSet = VK_NULL_HANDLE;
+            newWrite.dstBinding = w.binding;
+            newWrite.descriptorCount = 1;
+            newWrite.descriptorType = w.type;
+
+            if (isBufferType(w.type))
+                newWrite.pBufferInfo = &w.bufferInfo;
+            else
+                newWrite.pImageInfo = &w.imageInfo;
+
+            writes.push_back(newWrite);
+        }
+
+        s_CmdPushDescriptorSet(cmd, bindPoint, pipelineLayout, set, writes.size(), writes.data());
     }
 
-    bool DescriptorBuilder::build(VkDescriptorSet& set)
+    bool DescriptorBuilder::isBufferType(VkDescriptorType type)
     {
-        VkDescriptorSetLayout layout;
-        return build(set, layout);
+        return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+            type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+            type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+            type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     }
 }
@@ -4,6 +4,7 @@
 
 #include "Eos/Engine/DescriptorSets/DescriptorLayoutCache.hpp"
 #include "Eos/Engine/DescriptorSets/DescriptorAllocator.hpp"
+#include "Eos/Engine/DescriptorSets/DescriptorSetCache.hpp"
 
 #include <vulkan/vulkan.h>
 
@@ -12,8 +13,18 @@ namespace Eos
     class EOS_API DescriptorBuilder
     {
     public:
+        // When a set cache is given, building a set with the same layout and
+        // resources as an earlier one returns the earlier set
         static DescriptorBuilder begin(DescriptorLayoutCache* layoutCache,
-                DescriptorAllocator* allocator);
+                DescriptorAllocator* allocator, DescriptorSetCache* setCache = nullptr);
+
+        // Push descriptors require VK_KHR_push_descriptor
+        static void setupPushDescriptors(VkDevice device, bool supported);
+        static bool pushDescriptorsSupported() { return s_PushDescriptorsSupported; }
+
+        // Builds a layout with the push descriptor flag. Sets can not be
+        // built from it, the writes are recorded with push instead
+        DescriptorBuilder& setPushDescriptor();
 
         DescriptorBuilder& bindBuffer(uint32_t binding,
                 VkDescriptorBufferInfo* bufferInfo, VkDescriptorType type,
@@ -26,11 +37,36 @@ namespace Eos
         bool build(VkDescriptorSet& set, VkDescriptorSetLayout& layout);
         bool build(VkDescriptorSet& set);
 
+        // Writes the current writes into set. The bindings must match the ones
+        // set was built with. A set that is shared through the set cache, or
+        // that may still be used by submitted commands, is not written to:
+        // set is replaced with a new set and the old one is released to the
+        // allocator, which reuses it once those frames are complete
+        bool update(VkDescriptorSet& set, bool inFlight = true);
+
+        VkDescriptorSetLayout buildLayout();
+
+        void push(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint,
+                VkPipelineLayout pipelineLayout, uint32_t set);
+
     private:
-        std::vector<VkWriteDescriptorSet> m_Writes;
+        std::vector<DescriptorWrite> m_Writes;
         std::vector<VkDescriptorSetLayoutBinding> m_Bindings;
 
         DescriptorLayoutCache* m_Cache;
         DescriptorAllocator* m_Alloc;
+        DescriptorSetCache* m_SetCache;
+
+        bool m_PushDescriptor = false;
+
+        static bool s_PushDescriptorsSupported;
+        static PFN_vkCmdPushDescriptorSetKHR s_CmdPushDescriptorSet;
+
+    private:
+        void addBinding(uint32_t binding, VkDescriptorType type,
+                VkShaderStageFlags stageFlags);
+
+        static bool isBufferType(VkDescriptorType type);
+        void writeSet(VkDescriptorSet set, VkDescriptorSetLayout layout);
     };
 }
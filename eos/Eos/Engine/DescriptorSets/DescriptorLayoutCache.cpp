@@ -1,5 +1,7 @@
 #include "DescriptorLayoutCache.hpp"
 
+#include "Eos/Core/Hash.hpp"
+
 #include <algorithm>
 
 namespace Eos
@@ -7,7 +9,7 @@ namespace Eos
     bool DescriptorLayoutCache::DescriptorLayoutInfo::operator==(
             const DescriptorLayoutInfo& other) const
     {
-        if (other.bindings.size() != bindings.size())
+        if (other.bindings.size() != bindings.size() || other.flags != flags)
             return false;
 
         for (size_t i = 0; i < bindings.size(); i++)
@@ -25,18 +27,29 @@ namespace Eos
                 return false;
         }
 
-        return true;
+        return other.immutableSamplers == immutableSamplers;
     }
 
     size_t DescriptorLayoutCache::DescriptorLayoutInfo::hash() const
     {
-        size_t result = std::hash<size_t>()(bindings.size());
+        size_t result = 0;
+        hashCombine(result, bindings.size());
+        hashCombine(result, flags);
 
         for (const VkDescriptorSetLayoutBinding& b : bindings)
         {
-            size_t bindingHash = b.binding | b.descriptorType << 8 |
-                b.descriptorCount << 16 | b.stageFlags << 24;
-            result ^= std::hash<size_t>()(bindingHash);
+            hashCombine(result, b.binding);
+            hashCombine(result, static_cast<uint32_t>(b.descriptorType));
+            hashCombine(result, b.descriptorCount);
+            hashCombine(result, b.stageFlags);
+        }
+
+        for (const std::vector<VkSampler>& samplers : immutableSamplers)
+        {
+            hashCombine(result, samplers.size());
+
+            for (VkSampler sampler : samplers)
+                hashCombine(result, reinterpret_cast<uint64_t>(sampler));
         }
 
         return result;
@@ -49,10 +62,18 @@ namespace Eos
 
     void DescriptorLayoutCache::cleanup()
     {
+        for (auto pair : m_TemplateCache)
+        {
+            vkDestroyDescriptorUpdateTemplate(m_Device, pair.second, nullptr);
+        }
+
         for (auto pair : m_LayoutCache)
         {
             vkDestroyDescriptorSetLayout(m_Device, pair.second, nullptr);
         }
+
+        m_TemplateCache.clear();
+        m_LayoutCache.clear();
     }
 
     VkDescriptorSetLayout DescriptorLayoutCache::createDescriptorLayout(
@@ -60,6 +81,7 @@ namespace Eos
     {
         DescriptorLayoutInfo layoutInfo;
         layoutInfo.bindings.reserve(info->bindingCount);
+        layoutInfo.flags = info->flags;
         bool isSorted = true;
         int lastBinding = -1;
 
@@ -86,18 +108,73 @@ namespace Eos
                     });
         }
 
+        // Immutable samplers are copied as the pointers are only valid for
+        // the duration of this call
+        layoutInfo.immutableSamplers.resize(layoutInfo.bindings.size());
+        for (size_t i = 0; i < layoutInfo.bindings.size(); i++)
+        {
+            VkDescriptorSetLayoutBinding& binding = layoutInfo.bindings[i];
+            if (binding.pImmutableSamplers)
+            {
+                layoutInfo.immutableSamplers[i].assign(binding.pImmutableSamplers,
+                        binding.pImmutableSamplers + binding.descriptorCount);
+                binding.pImmutableSamplers = nullptr;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
         auto it = m_LayoutCache.find(layoutInfo);
         if (it != m_LayoutCache.end())
         {
+            m_Statistics.hits++;
             return (*it).second;
         }
         else
         {
+            m_Statistics.misses++;
+
             VkDescriptorSetLayout layout;
-            vkCreateDescriptorSetLayout(m_Device, info, nullptr, &layout);
+            EOS_VK_CHECK(vkCreateDescriptorSetLayout(m_Device, info, nullptr, &layout));
 
             m_LayoutCache[layoutInfo] = layout;
             return layout;
         }
     }
+
+    DescriptorLayoutCache::Statistics DescriptorLayoutCache::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Statistics.size = m_LayoutCache.size();
+        return m_Statistics;
+    }
+
+    VkDescriptorUpdateTemplate DescriptorLayoutCache::getUpdateTemplate(
+            VkDescriptorSetLayout layout,
+            const std::vector<VkDescriptorUpdateTemplateEntry>& entries)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_TemplateCache.find(layout);
+        if (it != m_TemplateCache.end())
+        {
+            return (*it).second;
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+        templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        templateInfo.pNext = nullptr;
+        templateInfo.descriptorUpdateEntryCount = entries.size();
+        templateInfo.pDescriptorUpdateEntries = entries.data();
+        templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        templateInfo.descriptorSetLayout = layout;
+
+        VkDescriptorUpdateTemplate updateTemplate;
+        EOS_VK_CHECK(vkCreateDescriptorUpdateTemplate(m_Device, &templateInfo, nullptr,
+                    &updateTemplate));
+
+        m_TemplateCache[layout] = updateTemplate;
+        return updateTemplate;
+    }
 }
@@ -2,6 +2,8 @@
 
 #include "Eos/EosPCH.hpp"
 
+#include <mutex>
+
 #include <vulkan/vulkan.h>
 
 namespace Eos
@@ -12,17 +14,33 @@ namespace Eos
         struct DescriptorLayoutInfo
         {
             std::vector<VkDescriptorSetLayoutBinding> bindings;
+            std::vector<std::vector<VkSampler>> immutableSamplers;
+            VkDescriptorSetLayoutCreateFlags flags = 0;
 
             bool operator==(const DescriptorLayoutInfo& other) const;
             size_t hash() const;
         };
 
+        struct Statistics
+        {
+            uint32_t hits = 0;
+            uint32_t misses = 0;
+            size_t size = 0;
+        };
+
     public:
         void init(VkDevice newDevice);
         void cleanup();
 
         VkDescriptorSetLayout createDescriptorLayout(VkDescriptorSetLayoutCreateInfo* info);
 
+        // Templates are created once per layout, the entries must describe
+        // every binding of the layout
+        VkDescriptorUpdateTemplate getUpdateTemplate(VkDescriptorSetLayout layout,
+                const std::vector<VkDescriptorUpdateTemplateEntry>& entries);
+
+        Statistics getStatistics();
+
     private:
         struct DescriptorLayoutHash
         {
@@ -34,6 +52,11 @@ namespace Eos
 
         std::unordered_map<DescriptorLayoutInfo, VkDescriptorSetLayout, DescriptorLayoutHash>
             m_LayoutCache;
+        std::unordered_map<VkDescriptorSetLayout, VkDescriptorUpdateTemplate> m_TemplateCache;
+        std::mutex m_Mutex;
+
+        Statistics m_Statistics;
+
         VkDevice m_Device;
     };
 }
@@ -0,0 +1,185 @@
+#include "DescriptorSetCache.hpp"
+
+#include "Eos/Core/Hash.hpp"
+
+namespace Eos
+{
+    // Only the fields of the used union member take part in the key. Padding
+    // and the unused bytes of the union are not guaranteed to be equal
+    static bool isBufferWrite(const DescriptorWrite& write)
+    {
+        return write.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+            write.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+            write.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+            write.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    }
+
+    bool DescriptorSetCache::DescriptorSetInfo::operator==(const DescriptorSetInfo& other) const
+    {
+        if (other.layout != layout || other.writes.size() != writes.size())
+            return false;
+
+        for (size_t i = 0; i < writes.size(); i++)
+        {
+            const DescriptorWrite& a = writes[i];
+            const DescriptorWrite& b = other.writes[i];
+
+            if (a.binding != b.binding || a.type != b.type)
+                return false;
+
+            if (isBufferWrite(a))
+            {
+                if (a.bufferInfo.buffer != b.bufferInfo.buffer ||
+                    a.bufferInfo.offset != b.bufferInfo.offset ||
+                    a.bufferInfo.range != b.bufferInfo.range)
+                    return false;
+            }
+            else
+            {
+                if (a.imageInfo.sampler != b.imageInfo.sampler ||
+                    a.imageInfo.imageView != b.imageInfo.imageView ||
+                    a.imageInfo.imageLayout != b.imageInfo.imageLayout)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t DescriptorSetCache::DescriptorSetInfo::hash() const
+    {
+        size_t result = std::hash<uint64_t>()(reinterpret_cast<uint64_t>(layout));
+
+        for (const DescriptorWrite& write : writes)
+        {
+            hashCombine(result, write.binding);
+            hashCombine(result, static_cast<uint32_t>(write.type));
+
+            if (isBufferWrite(write))
+            {
+                hashCombine(result, reinterpret_cast<uint64_t>(write.bufferInfo.buffer));
+                hashCombine(result, write.bufferInfo.offset);
+                hashCombine(result, write.bufferInfo.range);
+            }
+            else
+            {
+                hashCombine(result, reinterpret_cast<uint64_t>(write.imageInfo.sampler));
+                hashCombine(result, reinterpret_cast<uint64_t>(write.imageInfo.imageView));
+                hashCombine(result, static_cast<uint32_t>(write.imageInfo.imageLayout));
+            }
+        }
+
+        return result;
+    }
+
+    bool DescriptorSetCache::DescriptorSetInfo::references(uint64_t handle) const
+    {
+        for (const DescriptorWrite& write : writes)
+        {
+            switch (write.type)
+            {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                if (reinterpret_cast<uint64_t>(write.bufferInfo.buffer) == handle)
+                    return true;
+                break;
+            default:
+                if (reinterpret_cast<uint64_t>(write.imageInfo.imageView) == handle ||
+                    reinterpret_cast<uint64_t>(write.imageInfo.sampler) == handle)
+                    return true;
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    void DescriptorSetCache::init(VkDevice newDevice)
+    {
+        m_Device = newDevice;
+    }
+
+    void DescriptorSetCache::cleanup()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_SetCache.clear();
+    }
+
+    std::optional<VkDescriptorSet> DescriptorSetCache::find(const DescriptorSetInfo& info)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_SetCache.find(info);
+        if (it != m_SetCache.end())
+        {
+            m_Statistics.hits++;
+            return it->second;
+        }
+
+        m_Statistics.misses++;
+        return std::nullopt;
+    }
+
+    void DescriptorSetCache::insert(const DescriptorSetInfo& info, VkDescriptorSet set)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_SetCache[info] = set;
+    }
+
+    void DescriptorSetCache::remove(VkDescriptorSet set)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (auto it = m_SetCache.begin(); it != m_SetCache.end(); it++)
+        {
+            if (it->second == set)
+            {
+                m_SetCache.erase(it);
+                return;
+            }
+        }
+    }
+
+    bool DescriptorSetCache::contains(VkDescriptorSet set)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (const auto& [info, cachedSet] : m_SetCache)
+        {
+            if (cachedSet == set)
+                return true;
+        }
+
+        return false;
+    }
+
+    DescriptorSetCache::Statistics DescriptorSetCache::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Statistics.size = m_SetCache.size();
+        return m_Statistics;
+    }
+
+    void DescriptorSetCache::invalidateHandle(uint64_t handle)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (auto it = m_SetCache.begin(); it != m_SetCache.end();)
+        {
+            if (it->first.references(handle))
+            {
+                it = m_SetCache.erase(it);
+                m_Statistics.invalidated++;
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // A single descriptor as it is written into a set. The layout matches the
+    // data expected by a VkDescriptorUpdateTemplate, with one entry per binding
+    struct DescriptorWrite
+    {
+        uint32_t binding;
+        VkDescriptorType type;
+
+        union
+        {
+            VkDescriptorBufferInfo bufferInfo;
+            VkDescriptorImageInfo imageInfo;
+        };
+    };
+
+    class EOS_API DescriptorSetCache
+    {
+    public:
+        struct DescriptorSetInfo
+        {
+            VkDescriptorSetLayout layout;
+            std::vector<DescriptorWrite> writes;
+
+            bool operator==(const DescriptorSetInfo& other) const;
+            size_t hash() const;
+
+            bool references(uint64_t handle) const;
+        };
+
+        struct Statistics
+        {
+            uint32_t hits = 0;
+            uint32_t misses = 0;
+            uint32_t invalidated = 0;
+            size_t size = 0;
+        };
+
+    public:
+        void init(VkDevice newDevice);
+        void cleanup();
+
+        std::optional<VkDescriptorSet> find(const DescriptorSetInfo& info);
+        void insert(const DescriptorSetInfo& info, VkDescriptorSet set);
+
+        void remove(VkDescriptorSet set);
+        bool contains(VkDescriptorSet set);
+
+        template <typename T>
+        void invalidate(T handle) { invalidateHandle(reinterpret_cast<uint64_t>(handle)); }
+
+        Statistics getStatistics();
+    private:
+        struct DescriptorSetHash
+        {
+            std::size_t operator()(const DescriptorSetInfo& info) const
+            {
+                return info.hash();
+            }
+        };
+
+        // Sets are owned by the descriptor allocator, so entries that are
+        // removed are not freed until the allocator is cleaned up
+        std::unordered_map<DescriptorSetInfo, VkDescriptorSet, DescriptorSetHash> m_SetCache;
+        std::mutex m_Mutex;
+
+        Statistics m_Statistics;
+
+        VkDevice m_Device;
+    private:
+        void invalidateHandle(uint64_t handle);
+    };
+}
@@ -0,0 +1,134 @@
+#include "FrameDescriptorAllocator.hpp"
+
+namespace Eos
+{
+    void FrameDescriptorAllocator::init(VkDevice device, uint32_t framesInFlight)
+    {
+        m_Device = device;
+        m_Frames.resize(framesInFlight);
+        m_Released.resize(framesInFlight);
+    }
+
+    void FrameDescriptorAllocator::cleanup()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (auto& frame : m_Frames)
+        {
+            for (auto& [id, allocator] : frame)
+            {
+                allocator->cleanup();
+            }
+
+            frame.clear();
+        }
+
+        for (auto& released : m_Released)
+        {
+            for (auto& allocator : released)
+            {
+                allocator->cleanup();
+            }
+
+            released.clear();
+        }
+
+        for (auto& allocator : m_Spare)
+        {
+            allocator->cleanup();
+        }
+
+        m_Spare.clear();
+    }
+
+    void FrameDescriptorAllocator::nextFrame(uint32_t frameIndex)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_CurrentFrame = frameIndex;
+
+        for (auto& [id, allocator] : m_Frames[m_CurrentFrame])
+        {
+            allocator->resetPools();
+        }
+
+        for (auto& allocator : m_Released[m_CurrentFrame])
+        {
+            allocator->resetPools();
+            m_Spare.push_back(std::move(allocator));
+        }
+
+        m_Released[m_CurrentFrame].clear();
+    }
+
+    DescriptorAllocator* FrameDescriptorAllocator::getAllocator()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto& frame = m_Frames[m_CurrentFrame];
+        std::thread::id id = std::this_thread::get_id();
+
+        auto it = frame.find(id);
+        if (it != frame.end())
+        {
+            return it->second.get();
+        }
+
+        std::unique_ptr<DescriptorAllocator> allocator;
+        if (!m_Spare.empty())
+        {
+            allocator = std::move(m_Spare.back());
+            m_Spare.pop_back();
+        }
+        else
+        {
+            allocator = std::make_unique<DescriptorAllocator>();
+            allocator->init(m_Device, s_InitialSetsPerPool, true);
+        }
+
+        DescriptorAllocator* allocatorPtr = allocator.get();
+        frame[id] = std::move(allocator);
+
+        return allocatorPtr;
+    }
+
+    void FrameDescriptorAllocator::releaseThread()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        std::thread::id id = std::this_thread::get_id();
+
+        for (size_t i = 0; i < m_Frames.size(); i++)
+        {
+            auto it = m_Frames[i].find(id);
+            if (it == m_Frames[i].end())
+                continue;
+
+            // Sets from it can still be used by that frame's commands
+            m_Released[i].push_back(std::move(it->second));
+            m_Frames[i].erase(it);
+        }
+    }
+
+    DescriptorAllocator::Statistics FrameDescriptorAllocator::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        DescriptorAllocator::Statistics total{};
+        for (auto& frame : m_Frames)
+        {
+            for (auto& [id, allocator] : frame)
+            {
+                const DescriptorAllocator::Statistics& stats = allocator->getStatistics();
+
+                total.poolsCreated += stats.poolsCreated;
+                total.poolsInUse += stats.poolsInUse;
+                total.setsPerPool = std::max(total.setsPerPool, stats.setsPerPool);
+                total.setsAllocated += stats.setsAllocated;
+                total.resets += stats.resets;
+            }
+        }
+
+        return total;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/DescriptorSets/DescriptorAllocator.hpp"
+
+#include <mutex>
+#include <thread>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Holds a DescriptorAllocator per thread for every frame in flight. Sets
+    // allocated through it are only valid for the frame they were allocated in,
+    // as the allocators are reset once that frame's fence has been signalled
+    class EOS_API FrameDescriptorAllocator
+    {
+    public:
+        void init(VkDevice device, uint32_t framesInFlight);
+        void cleanup();
+
+        void nextFrame(uint32_t frameIndex);
+
+        DescriptorAllocator* getAllocator();
+
+        // Call before a thread that used getAllocator exits. Its allocators
+        // are reset and reused by other threads once their frames are done
+        void releaseThread();
+
+        DescriptorAllocator::Statistics getStatistics();
+    private:
+        static constexpr uint32_t s_InitialSetsPerPool = 64;
+
+        VkDevice m_Device;
+        uint32_t m_CurrentFrame = 0;
+
+        std::mutex m_Mutex;
+        std::vector<std::unordered_map<std::thread::id,
+            std::unique_ptr<DescriptorAllocator>>> m_Frames;
+
+        // Per frame, allocators of released threads that may still be in use
+        std::vector<std::vector<std::unique_ptr<DescriptorAllocator>>> m_Released;
+        std::vector<std::unique_ptr<DescriptorAllocator>> m_Spare;
+    };
+}
@@ -6,6 +6,8 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan_core.h>
 
+#include <cstring>
+
 #include "Eos/Engine/GlobalData.hpp"
 
 namespace Eos
@@ -23,17 +25,30 @@ namespace Eos
 
     PipelineBuilder Engine::createPipelineBuilder()
     {
-        return PipelineBuilder::begin(&m_Device, &m_Renderpass.renderPass).defaultValues();
+        return PipelineBuilder::begin(&m_Device, &m_Renderpass.renderPass,
+                &m_PipelineLayoutCache).defaultValues();
     }
 
     ComputePipelineBuilder Engine::createComputePipelineBuilder()
     {
-        return ComputePipelineBuilder::begin(&m_Device);
+        return ComputePipelineBuilder::begin(&m_Device, &m_PipelineLayoutCache);
     }
 
     DescriptorBuilder Engine::createDescriptorBuilder()
     {
-        return DescriptorBuilder::begin(&m_DescriptorLayoutCache, &m_DescriptorAllocator);
+        return DescriptorBuilder::begin(&m_DescriptorLayoutCache, &m_DescriptorAllocator,
+                &m_DescriptorSetCache);
+    }
+
+    DescriptorBuilder Engine::createFrameDescriptorBuilder()
+    {
+        return DescriptorBuilder::begin(&m_DescriptorLayoutCache,
+                m_FrameDescriptorAllocator.getAllocator());
+    }
+
+    DescriptorBuilder Engine::createPushDescriptorBuilder()
+    {
+        return DescriptorBuilder::begin(&m_DescriptorLayoutCache, nullptr).setPushDescriptor();
     }
 
     void Engine::cleanup()
@@ -42,17 +57,33 @@ namespace Eos
         {
             vkDeviceWaitIdle(m_Device);
 
+            m_ComputeJobs.cleanup();
+            m_AsyncCompute.cleanup();
+            m_Primitives.cleanup();
+            m_TextureLoader.cleanup();
+            m_TextureStreamer.cleanup();
+            m_Readback.cleanup();
+            m_Defragmenter.cleanup();
+
             ComputePipelineBuilder::cleanup();
             PipelineBuilder::cleanup();
-            ComputeShader::cleanup();
+            m_PipelineLayoutCache.cleanup();
 
+            m_DescriptorSetCache.cleanup();
             m_DescriptorAllocator.cleanup();
+            m_FrameDescriptorAllocator.cleanup();
             m_DescriptorLayoutCache.cleanup();
 
             vkDeviceWaitIdle(m_Device);
 
+            m_CommandPools.cleanup();
+            m_FencePool.cleanup();
+            m_SemaphorePool.cleanup();
+
             m_DeletionQueue.flush();
 
+            m_SamplerCache.cleanup();
+
             vkDestroyRenderPass(m_Device, m_Renderpass.renderPass, nullptr);
 
             for (size_t i = 0; i < m_Framebuffers.size(); i++)
@@ -86,8 +117,21 @@ namespace Eos
         initSwapchain();
 
         GlobalData::s_Device = &m_Device;
+        GlobalData::s_PhysicalDevice = &m_PhysicalDevice;
+        GlobalData::s_MaxSamplerAnisotropy = &m_MaxSamplerAnisotropy;
         GlobalData::s_Allocator = &m_Allocator;
+        GlobalData::s_MemoryStats = &m_MemoryStats;
+        GlobalData::s_Defragmenter = &m_Defragmenter;
         GlobalData::s_DeletionQueue = &m_DeletionQueue;
+        GlobalData::s_DescriptorSetCache = &m_DescriptorSetCache;
+        GlobalData::s_SamplerCache = &m_SamplerCache;
+        GlobalData::s_CommandPools = &m_CommandPools;
+        GlobalData::s_FencePool = &m_FencePool;
+        GlobalData::s_SemaphorePool = &m_SemaphorePool;
+
+        m_CommandPools.init(m_Device);
+        m_FencePool.init(m_Device);
+        m_SemaphorePool.init(m_Device);
 
         if (m_SetupDetails.renderpassCreationFunc.has_value())
             (m_SetupDetails.renderpassCreationFunc.value())(m_Renderpass);
@@ -104,6 +148,15 @@ namespace Eos
         TransferSubmit::setup(&m_TransferQueue);
         ComputeShader::setup(&m_ComputeQueue);
 
+        m_ComputeJobs.init(&m_ComputeQueue);
+        m_AsyncCompute.init(&m_ComputeQueue, &m_GraphicsQueue, m_SetupDetails.framesInFlight);
+        m_Primitives.init();
+
+        m_TextureLoader.init(&m_GraphicsQueue, m_SetupDetails.framesInFlight);
+        m_TextureStreamer.init(&m_GraphicsQueue, &m_TextureLoader.getPlaceholder(),
+                m_SetupDetails.framesInFlight);
+        m_Readback.init(m_SetupDetails.framesInFlight);
+
         initImgui();
 
         m_Initialized = true;
@@ -113,12 +166,32 @@ namespace Eos
 
     RenderInformation Engine::preRender()
     {
-        static uint32_t currentFrame = 0;
-        FrameData& frame = m_Frames[currentFrame % m_SetupDetails.framesInFlight];
+        RenderInformation information = beginFrame();
+
+        beginRenderPass(information);
+
+        return information;
+    }
+
+    RenderInformation Engine::beginFrame()
+    {
+        FrameData& frame = m_Frames[m_CurrentFrame % m_SetupDetails.framesInFlight];
 
         EOS_VK_CHECK(vkWaitForFences(m_Device, 1, &frame.renderFence, true, 1000000000));
         EOS_VK_CHECK(vkResetFences(m_Device, 1, &frame.renderFence));
 
+        // The GPU has finished with this frame's descriptor sets
+        m_FrameDescriptorAllocator.nextFrame(m_CurrentFrame);
+        m_DescriptorAllocator.nextFrame(m_FrameCount);
+        m_MemoryStats.nextFrame();
+        m_AsyncCompute.nextFrame(m_CurrentFrame);
+        m_ComputeJobs.update();
+        m_CommandPools.update();
+
+        m_TextureLoader.update(m_FrameCount);
+        m_TextureStreamer.update(m_FrameCount);
+        m_Readback.update(m_FrameCount);
+
         uint32_t swapchainImageIndex;
 
         // Attempt a couple times
@@ -152,6 +225,31 @@ namespace Eos
 
         EOS_VK_CHECK(vkBeginCommandBuffer(cmd, &cmdBeginInfo));
 
+        // Moves go first, everything recorded after sees the new resources
+        m_Defragmenter.update(cmd, m_FrameCount);
+
+        RenderInformation information;
+        information.frame = &frame;
+        information.swapchainImageIndex = swapchainImageIndex;
+        information.cmd = &frame.commandBuffer;
+
+        m_FrameCount++;
+        m_CurrentFrame++;
+        if (m_CurrentFrame >= m_SetupDetails.framesInFlight)
+            m_CurrentFrame = 0;
+
+        ImGui_ImplVulkan_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+
+        ImGui::NewFrame();
+
+        return information;
+    }
+
+    void Engine::beginRenderPass(RenderInformation& information)
+    {
+        VkCommandBuffer cmd = information.frame->commandBuffer;
+
         std::vector<VkClearValue> clearValues;
 
         if (m_SetupDetails.renderClearValues.has_value())
@@ -164,6 +262,9 @@ namespace Eos
             clearValues = { background };
         }
 
+        // Compute results submitted this frame become visible to the draws
+        m_AsyncCompute.recordGraphicsAcquire(cmd);
+
         VkRenderPassBeginInfo rpInfo{};
         rpInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         rpInfo.pNext = nullptr;
@@ -171,27 +272,11 @@ namespace Eos
         rpInfo.renderArea.offset.x = 0;
         rpInfo.renderArea.offset.y = 0;
         rpInfo.renderArea.extent = m_Swapchain.extent;
-        rpInfo.framebuffer = m_Framebuffers[swapchainImageIndex];
+        rpInfo.framebuffer = m_Framebuffers[information.swapchainImageIndex];
         rpInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
         rpInfo.pClearValues = clearValues.data();
 
         vkCmdBeginRenderPass(cmd, &rpInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-        RenderInformation information;
-        information.frame = &frame;
-        information.swapchainImageIndex = swapchainImageIndex;
-        information.cmd = &cmd;
-
-        currentFrame++;
-        if (currentFrame >= m_SetupDetails.framesInFlight)
-            currentFrame = 0;
-
-        ImGui_ImplVulkan_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-
-        ImGui::NewFrame();
-
-        return information;
     }
 
     void Engine::postRender(RenderInformation& information)
@@ -203,22 +288,31 @@ namespace Eos
 
         vkCmdEndRenderPass(cmd);
 
+        m_AsyncCompute.recordGraphicsRelease(cmd);
+
         EOS_VK_CHECK(vkEndCommandBuffer(cmd));
 
-        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        std::vector<VkSemaphore> waitSemaphores = { information.frame->presentSemaphore };
+        std::vector<VkPipelineStageFlags> waitStages = {
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+        };
+        std::vector<VkSemaphore> signalSemaphores = { information.frame->renderSemaphore };
+
+        m_AsyncCompute.getGraphicsSemaphores(waitSemaphores, waitStages, signalSemaphores,
+                information.frame->renderFence);
 
         VkSubmitInfo submit{};
         submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submit.pNext = nullptr;
-        submit.pWaitDstStageMask = &waitStage;
-        submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &information.frame->presentSemaphore;
-        submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &information.frame->renderSemaphore;
+        submit.pWaitDstStageMask = waitStages.data();
+        submit.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        submit.pWaitSemaphores = waitSemaphores.data();
+        submit.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+        submit.pSignalSemaphores = signalSemaphores.data();
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
 
-        EOS_VK_CHECK(vkQueueSubmit(m_GraphicsQueue.queue, 1, &submit, information.frame->renderFence));
+        EOS_VK_CHECK(m_GraphicsQueue.submit(1, &submit, information.frame->renderFence));
         
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -228,7 +322,12 @@ namespace Eos
         presentInfo.waitSemaphoreCount = 1;
         presentInfo.pWaitSemaphores = &information.frame->renderSemaphore;
         presentInfo.pImageIndices = &information.swapchainImageIndex;
-        VkResult result = vkQueuePresentKHR(m_GraphicsQueue.queue, &presentInfo);
+
+        VkResult result;
+        {
+            std::lock_guard<std::mutex> lock(*m_GraphicsQueue.mutex);
+            result = vkQueuePresentKHR(m_GraphicsQueue.queue, &presentInfo);
+        }
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
         {
@@ -259,11 +358,27 @@ namespace Eos
         VkPhysicalDeviceFeatures deviceFeatures{};
         if (m_SetupDetails.float64)
             deviceFeatures.shaderFloat64 = true;
+        if (m_SetupDetails.samplerAnisotropy)
+            deviceFeatures.samplerAnisotropy = true;
+
+        // Used by ComputeJobSystem tickets
+        VkPhysicalDeviceVulkan12Features deviceFeatures12{};
+        deviceFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        deviceFeatures12.timelineSemaphore = true;
+
+        // Used by BarrierBatcher for vkCmdPipelineBarrier2
+        VkPhysicalDeviceVulkan13Features deviceFeatures13{};
+        deviceFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        deviceFeatures13.synchronization2 = true;
 
         vkb::PhysicalDeviceSelector selector{ vkbInstance };
         vkb::PhysicalDevice vkbPhysicalDevice = selector.set_minimum_version(1, 3)
             .set_surface(m_Surface)
             .set_required_features(deviceFeatures)
+            .set_required_features_12(deviceFeatures12)
+            .set_required_features_13(deviceFeatures13)
+            .add_desired_extension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)
+            .add_desired_extension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)
             .select()
             .value();
 
@@ -273,6 +388,13 @@ namespace Eos
         m_Device = vkbDevice.device;
         m_PhysicalDevice = vkbPhysicalDevice.physical_device;
 
+        if (m_SetupDetails.samplerAnisotropy)
+        {
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+            m_MaxSamplerAnisotropy = properties.limits.maxSamplerAnisotropy;
+        }
+
         m_GraphicsQueue.queue = vkbDevice.get_queue(vkb::QueueType::graphics).value();
         m_GraphicsQueue.family = vkbDevice.get_queue_index(vkb::QueueType::graphics).value();
 
@@ -302,8 +424,16 @@ namespace Eos
         allocatorInfo.physicalDevice = m_PhysicalDevice;
         allocatorInfo.device = m_Device;
         allocatorInfo.instance = m_Instance;
+
+        // Lets VMA report real heap budgets instead of estimates
+        if (isDeviceExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+
         vmaCreateAllocator(&allocatorInfo, &m_Allocator);
 
+        m_MemoryStats.init(m_Allocator);
+        m_Defragmenter.init(m_Device, m_Allocator, m_SetupDetails.framesInFlight);
+
         m_DeletionQueue.pushFunction([=]() {
                 vmaDestroyAllocator(m_Allocator);
             });
@@ -456,7 +586,14 @@ namespace Eos
     void Engine::initDescriptorSets()
     {
         m_DescriptorLayoutCache.init(m_Device);
-        m_DescriptorAllocator.init(m_Device);
+        m_DescriptorSetCache.init(m_Device);
+        m_PipelineLayoutCache.init(m_Device);
+        m_SamplerCache.init(m_Device);
+        m_DescriptorAllocator.init(m_Device, 1000, false, m_SetupDetails.framesInFlight);
+        m_FrameDescriptorAllocator.init(m_Device, m_SetupDetails.framesInFlight);
+
+        DescriptorBuilder::setupPushDescriptors(m_Device,
+                isDeviceExtensionSupported(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME));
 
         EOS_CORE_LOG_INFO("Created Descriptor sets");
     }
@@ -548,4 +685,22 @@ namespace Eos
 
         EOS_ENABLE_LOGGER();
     }
+
+    bool Engine::isDeviceExtensionSupported(const char* extensionName)
+    {
+        uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount,
+                extensions.data());
+
+        for (const VkExtensionProperties& extension : extensions)
+        {
+            if (strcmp(extension.extensionName, extensionName) == 0)
+                return true;
+        }
+
+        return false;
+    }
 }
@@ -8,15 +8,28 @@
 #include "Eos/Engine/DescriptorSets/DescriptorAllocator.hpp"
 #include "Eos/Engine/DescriptorSets/DescriptorLayoutCache.hpp"
 #include "Eos/Engine/DescriptorSets/DescriptorBuilder.hpp"
+#include "Eos/Engine/DescriptorSets/FrameDescriptorAllocator.hpp"
 
 #include "Eos/Engine/Pipelines/ComputePipelineBuilder.hpp"
 #include "Eos/Engine/Pipelines/PipelineBuilder.hpp"
+#include "Eos/Engine/Pipelines/PipelineLayoutCache.hpp"
 
+#include "Eos/Engine/AsyncCompute.hpp"
+#include "Eos/Engine/AsyncTextureLoader.hpp"
+#include "Eos/Engine/CommandPools.hpp"
+#include "Eos/Engine/ComputeJobs.hpp"
 #include "Eos/Engine/ComputeShader.hpp"
+#include "Eos/Engine/Defragmenter.hpp"
+#include "Eos/Engine/GpuPrimitives.hpp"
+#include "Eos/Engine/MemoryStats.hpp"
 #include "Eos/Engine/Mesh.hpp"
+#include "Eos/Engine/ReadbackRing.hpp"
 #include "Eos/Engine/RenderPassBuilder.hpp"
+#include "Eos/Engine/SamplerCache.hpp"
 #include "Eos/Engine/Shader.hpp"
+#include "Eos/Engine/SyncPools.hpp"
 #include "Eos/Engine/Texture.hpp"
+#include "Eos/Engine/TextureStreamer.hpp"
 
 #include "Eos/Engine/Submits/TransferSubmit.hpp"
 #include "Eos/Engine/Submits/GraphicsSubmit.hpp"
@@ -34,6 +47,7 @@ namespace Eos
         bool vsync;
         uint32_t framesInFlight;
         bool float64;
+        bool samplerAnisotropy;
         VkSurfaceFormatKHR swapchainFormat;
 
         std::optional<std::function<void(RenderPass&)>> renderpassCreationFunc;
@@ -69,6 +83,31 @@ namespace Eos
         PipelineBuilder createPipelineBuilder();
         ComputePipelineBuilder createComputePipelineBuilder();
         DescriptorBuilder createDescriptorBuilder();
+        // Sets are valid from beginFrame until the frame's postRender
+        DescriptorBuilder createFrameDescriptorBuilder();
+        DescriptorBuilder createPushDescriptorBuilder();
+
+        DescriptorAllocator& getDescriptorAllocator() { return m_DescriptorAllocator; }
+        FrameDescriptorAllocator& getFrameDescriptorAllocator()
+            { return m_FrameDescriptorAllocator; }
+        DescriptorSetCache& getDescriptorSetCache() { return m_DescriptorSetCache; }
+        DescriptorLayoutCache& getDescriptorLayoutCache() { return m_DescriptorLayoutCache; }
+        PipelineLayoutCache& getPipelineLayoutCache() { return m_PipelineLayoutCache; }
+        SamplerCache& getSamplerCache() { return m_SamplerCache; }
+
+        MemoryStats& getMemoryStats() { return m_MemoryStats; }
+        Defragmenter& getDefragmenter() { return m_Defragmenter; }
+
+        CommandPools& getCommandPools() { return m_CommandPools; }
+        FencePool& getFencePool() { return m_FencePool; }
+        SemaphorePool& getSemaphorePool() { return m_SemaphorePool; }
+
+        AsyncCompute& getAsyncCompute() { return m_AsyncCompute; }
+        ComputeJobSystem& getComputeJobs() { return m_ComputeJobs; }
+        GpuPrimitives& getPrimitives() { return m_Primitives; }
+        AsyncTextureLoader& getTextureLoader() { return m_TextureLoader; }
+        TextureStreamer& getTextureStreamer() { return m_TextureStreamer; }
+        ReadbackRing& getReadback() { return m_Readback; }
 
         std::shared_ptr<Window>& getWindow() { return m_Window; }
         Swapchain& getSwapchain() { return m_Swapchain; }
@@ -81,7 +120,14 @@ namespace Eos
 
         void init(const EngineSetupDetails& setupDetails);
 
+        // Same as beginFrame followed by beginRenderPass
         RenderInformation preRender();
+
+        // Waits for the frame and begins its command buffer. Work recorded
+        // before beginRenderPass is part of the same submission as the draws
+        RenderInformation beginFrame();
+        void beginRenderPass(RenderInformation& information);
+
         void postRender(RenderInformation& information);
 
         Engine(const Engine&) = delete;
@@ -99,6 +145,8 @@ namespace Eos
         VkDevice m_Device;
         VkSurfaceKHR m_Surface;
 
+        float m_MaxSamplerAnisotropy = 1.0f;
+
         VmaAllocator m_Allocator;
 
         Queue m_GraphicsQueue;
@@ -111,11 +159,32 @@ namespace Eos
         std::vector<VkFramebuffer> m_Framebuffers;
 
         std::vector<FrameData> m_Frames;
+        uint32_t m_CurrentFrame = 0;
+        // Never wraps, unlike m_CurrentFrame
+        uint64_t m_FrameCount = 0;
 
         UploadContext m_UploadContext;
 
         DescriptorAllocator m_DescriptorAllocator;
+        FrameDescriptorAllocator m_FrameDescriptorAllocator;
         DescriptorLayoutCache m_DescriptorLayoutCache;
+        DescriptorSetCache m_DescriptorSetCache;
+        PipelineLayoutCache m_PipelineLayoutCache;
+        SamplerCache m_SamplerCache;
+
+        MemoryStats m_MemoryStats;
+        Defragmenter m_Defragmenter;
+
+        CommandPools m_CommandPools;
+        FencePool m_FencePool;
+        SemaphorePool m_SemaphorePool;
+
+        AsyncCompute m_AsyncCompute;
+        ComputeJobSystem m_ComputeJobs;
+        GpuPrimitives m_Primitives;
+        AsyncTextureLoader m_TextureLoader;
+        TextureStreamer m_TextureStreamer;
+        ReadbackRing m_Readback;
 
         DeletionQueue m_DeletionQueue;
 
@@ -134,5 +203,7 @@ namespace Eos
         void initImgui();
 
         void recreateSwapchain();
+
+        bool isDeviceExtensionSupported(const char* extensionName);
     };
 }
@@ -3,8 +3,18 @@
 namespace Eos
 {
     VkDevice* GlobalData::s_Device;
+    VkPhysicalDevice* GlobalData::s_PhysicalDevice;
     VmaAllocator* GlobalData::s_Allocator;
+    MemoryStats* GlobalData::s_MemoryStats;
+    Defragmenter* GlobalData::s_Defragmenter;
     DeletionQueue* GlobalData::s_DeletionQueue;
+    DescriptorSetCache* GlobalData::s_DescriptorSetCache;
+    SamplerCache* GlobalData::s_SamplerCache;
+    CommandPools* GlobalData::s_CommandPools;
+    FencePool* GlobalData::s_FencePool;
+    SemaphorePool* GlobalData::s_SemaphorePool;
 
     ImGuiContext* GlobalData::s_ImguiContext;
+
+    float* GlobalData::s_MaxSamplerAnisotropy;
 }
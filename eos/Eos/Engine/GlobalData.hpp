@@ -3,31 +3,61 @@
 #include "Eos/EosPCH.hpp"
 
 #include "Eos/Core/DeletionQueue.hpp"
+#include "Eos/Engine/CommandPools.hpp"
+#include "Eos/Engine/DescriptorSets/DescriptorSetCache.hpp"
+#include "Eos/Engine/MemoryStats.hpp"
+#include "Eos/Engine/SamplerCache.hpp"
+#include "Eos/Engine/SyncPools.hpp"
 
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 
 namespace Eos
 {
+    class Defragmenter;
+
     class EOS_API GlobalData
     {
     public:
         static VkDevice& getDevice() { return *s_Device; }
+        static VkPhysicalDevice& getPhysicalDevice() { return *s_PhysicalDevice; }
 
         static VmaAllocator& getAllocator() { return *s_Allocator; }
+        static MemoryStats& getMemoryStats() { return *s_MemoryStats; }
+        static Defragmenter& getDefragmenter() { return *s_Defragmenter; }
 
         static DeletionQueue& getDeletionQueue() { return *s_DeletionQueue; }
 
+        static DescriptorSetCache& getDescriptorSetCache() { return *s_DescriptorSetCache; }
+        static SamplerCache& getSamplerCache() { return *s_SamplerCache; }
+
+        static CommandPools& getCommandPools() { return *s_CommandPools; }
+        static FencePool& getFencePool() { return *s_FencePool; }
+        static SemaphorePool& getSemaphorePool() { return *s_SemaphorePool; }
+
         static ImGuiContext& getImguiContext() { return *s_ImguiContext; }
+
+        // 1.0 when anisotropic filtering has not been enabled
+        static float getMaxSamplerAnisotropy() { return *s_MaxSamplerAnisotropy; }
     private:
         friend class Engine;
 
         static VkDevice* s_Device;
+        static VkPhysicalDevice* s_PhysicalDevice;
         static VmaAllocator* s_Allocator;
+        static MemoryStats* s_MemoryStats;
+        static Defragmenter* s_Defragmenter;
 
         static DeletionQueue* s_DeletionQueue;
+        static DescriptorSetCache* s_DescriptorSetCache;
+        static SamplerCache* s_SamplerCache;
+        static CommandPools* s_CommandPools;
+        static FencePool* s_FencePool;
+        static SemaphorePool* s_SemaphorePool;
 
         static ImGuiContext* s_ImguiContext;
+
+        static float* s_MaxSamplerAnisotropy;
     private:
         GlobalData() {}
         ~GlobalData() {}
@@ -0,0 +1,431 @@
+#include "GpuPrimitives.hpp"
+
+#include "Eos/Engine/BarrierBatcher.hpp"
+#include "Eos/Engine/ComputeShader.hpp"
+#include "Eos/Engine/Engine.hpp"
+#include "Eos/Engine/GlobalData.hpp"
+
+namespace Eos
+{
+    // Has to be a power of two for the shared memory reductions
+    static constexpr uint32_t c_WorkgroupSize = 256;
+    static constexpr uint32_t c_ItemsPerThread = 4;
+    static constexpr uint32_t c_BlockSize = c_WorkgroupSize * c_ItemsPerThread;
+
+    static constexpr uint32_t c_RadixBits = 4;
+    static constexpr uint32_t c_Radix = 1 << c_RadixBits;
+
+    static constexpr uint32_t c_MaxGroupCount = 65535;
+
+    // Scratch slots, scan levels use c_ScanSlot onwards
+    static constexpr uint32_t c_PingSlot = 0;
+    static constexpr uint32_t c_PongSlot = 1;
+    static constexpr uint32_t c_CountSlot = 2;
+    static constexpr uint32_t c_ScanSlot = 3;
+
+    struct KernelInfo
+    {
+        const char* generic;
+        const char* subgroup;
+        uint32_t itemsPerThread;
+    };
+
+    // Indexed by GpuPrimitives::Kernel
+    static const KernelInfo c_Kernels[] = {
+        { "Reduce", "ReduceSubgroup", c_ItemsPerThread },
+        { "Scan", "ScanSubgroup", c_ItemsPerThread },
+        { "ScanAdd", "ScanAdd", c_ItemsPerThread },
+        { "Compact", "Compact", 1 },
+        { "RadixHistogram", "RadixHistogram", 1 },
+        { "RadixScatter", "RadixScatterSubgroup", 1 },
+        { "Histogram", "Histogram", c_ItemsPerThread }
+    };
+
+    struct ScanConstants
+    {
+        uint32_t count;
+        uint32_t exclusive;
+        uint32_t writeBlockSums;
+    };
+
+    struct RadixConstants
+    {
+        uint32_t count;
+        uint32_t shift;
+        uint32_t groupCount;
+    };
+
+    struct HistogramConstants
+    {
+        uint32_t count;
+        uint32_t binCount;
+    };
+
+    static uint32_t divideRoundUp(uint32_t value, uint32_t divisor)
+    {
+        // Written this way so counts close to UINT32_MAX do not wrap
+        return value / divisor + (value % divisor != 0 ? 1 : 0);
+    }
+
+    void GpuPrimitives::init(const std::string& shaderDirectory)
+    {
+        m_ShaderDirectory = shaderDirectory;
+
+        VkPhysicalDeviceSubgroupProperties subgroupProperties{};
+        subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+        subgroupProperties.pNext = nullptr;
+
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &subgroupProperties;
+
+        vkGetPhysicalDeviceProperties2(GlobalData::getPhysicalDevice(), &properties);
+
+        VkSubgroupFeatureFlags required = VK_SUBGROUP_FEATURE_BASIC_BIT |
+            VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+
+        m_SubgroupsSupported = (subgroupProperties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+            (subgroupProperties.supportedOperations & required) == required;
+        m_UseSubgroups = m_SubgroupsSupported;
+
+        // Every dispatch binds different buffers, so push them rather than
+        // allocating a set each time
+        m_UsePushDescriptors = DescriptorBuilder::pushDescriptorsSupported();
+
+        // Kernels use a subset of the bindings, unused ones are bound to
+        // any valid buffer
+        VkDescriptorBufferInfo unused{};
+
+        DescriptorBuilder builder = createDescriptorBuilder();
+        for (uint32_t i = 0; i < c_Bindings; i++)
+        {
+            builder.bindBuffer(i, &unused, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    VK_SHADER_STAGE_COMPUTE_BIT);
+        }
+
+        m_SetLayout = builder.buildLayout();
+
+        VkPushConstantRange pushConstants{};
+        pushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstants.offset = 0;
+        pushConstants.size = 4 * sizeof(uint32_t);
+
+        VkPipelineLayoutCreateInfo layoutCI = Pipeline::pipelineLayoutCreateInfo();
+        layoutCI.setLayoutCount = 1;
+        layoutCI.pSetLayouts = &m_SetLayout;
+        layoutCI.pushConstantRangeCount = 1;
+        layoutCI.pPushConstantRanges = &pushConstants;
+
+        m_PipelineLayout = Engine::get()->getPipelineLayoutCache().createPipelineLayout(&layoutCI);
+
+        EOS_CORE_LOG_INFO("GPU primitives use {} kernels",
+                m_UseSubgroups ? "subgroup" : "shared memory");
+    }
+
+    void GpuPrimitives::cleanup()
+    {
+        for (auto& [slot, buffer] : m_Scratch)
+            buffer.destroy();
+        for (Buffer& buffer : m_Retired)
+            buffer.destroy();
+
+        m_Scratch.clear();
+        m_Retired.clear();
+
+        // Owned by ComputePipelineBuilder
+        m_Pipelines.clear();
+    }
+
+    void GpuPrimitives::reduce(VkCommandBuffer cmd, const Buffer& input, const Buffer& output,
+            uint32_t count, ReduceOp op)
+    {
+        if (count == 0 || !checkCount(count, c_BlockSize))
+            return;
+
+        computeBarrier(cmd);
+
+        // Each pass leaves one value per workgroup until a single one is left
+        const Buffer* source = &input;
+        uint32_t slot = c_PingSlot;
+
+        while (true)
+        {
+            uint32_t groupCount = divideRoundUp(count, c_BlockSize);
+            const Buffer* destination = groupCount == 1 ? &output :
+                &getScratch(slot, groupCount * sizeof(uint32_t));
+
+            dispatch(cmd, Kernel::Reduce, { source, destination }, &count, sizeof(uint32_t),
+                    groupCount, op);
+
+            if (groupCount == 1)
+                break;
+
+            computeBarrier(cmd);
+
+            source = destination;
+            count = groupCount;
+            slot = slot == c_PingSlot ? c_PongSlot : c_PingSlot;
+        }
+    }
+
+    void GpuPrimitives::inclusiveScan(VkCommandBuffer cmd, const Buffer& input,
+            const Buffer& output, uint32_t count)
+    {
+        if (count == 0 || !checkCount(count, c_BlockSize))
+            return;
+
+        computeBarrier(cmd);
+        scan(cmd, input, output, count, false);
+    }
+
+    void GpuPrimitives::exclusiveScan(VkCommandBuffer cmd, const Buffer& input,
+            const Buffer& output, uint32_t count)
+    {
+        if (count == 0 || !checkCount(count, c_BlockSize))
+            return;
+
+        computeBarrier(cmd);
+        scan(cmd, input, output, count, true);
+    }
+
+    void GpuPrimitives::compact(VkCommandBuffer cmd, const Buffer& values, const Buffer& flags,
+            const Buffer& output, const Buffer& countOutput, uint32_t count)
+    {
+        if (count == 0 || !checkCount(count, c_WorkgroupSize))
+            return;
+
+        computeBarrier(cmd);
+
+        Buffer& indices = getScratch(c_PingSlot, count * sizeof(uint32_t));
+        scan(cmd, flags, indices, count, true);
+
+        computeBarrier(cmd);
+
+        dispatch(cmd, Kernel::Compact, { &values, &flags, &indices, &output, &countOutput },
+                &count, sizeof(uint32_t), divideRoundUp(count, c_WorkgroupSize));
+    }
+
+    void GpuPrimitives::radixSort(VkCommandBuffer cmd, const Buffer& keys, const Buffer& values,
+            uint32_t count, uint32_t keyBits)
+    {
+        if (count == 0 || !checkCount(count, c_WorkgroupSize))
+            return;
+
+        computeBarrier(cmd);
+
+        uint32_t groupCount = divideRoundUp(count, c_WorkgroupSize);
+        uint32_t countsSize = c_Radix * groupCount;
+
+        Buffer& tempKeys = getScratch(c_PingSlot, count * sizeof(uint32_t));
+        Buffer& tempValues = getScratch(c_PongSlot, count * sizeof(uint32_t));
+        Buffer& counts = getScratch(c_CountSlot, countsSize * sizeof(uint32_t));
+
+        // An even number of passes, so the last one writes back into keys
+        uint32_t passes = divideRoundUp(std::min(keyBits, 32u), 8) * (8 / c_RadixBits);
+
+        for (uint32_t pass = 0; pass < passes; pass++)
+        {
+            bool fromInput = pass % 2 == 0;
+
+            const Buffer& sourceKeys = fromInput ? keys : tempKeys;
+            const Buffer& sourceValues = fromInput ? values : tempValues;
+            const Buffer& destinationKeys = fromInput ? tempKeys : keys;
+            const Buffer& destinationValues = fromInput ? tempValues : values;
+
+            RadixConstants constants{ count, pass * c_RadixBits, groupCount };
+
+            dispatch(cmd, Kernel::RadixHistogram, { &sourceKeys, &counts },
+                    &constants, sizeof(RadixConstants), groupCount);
+
+            computeBarrier(cmd);
+            scan(cmd, counts, counts, countsSize, true);
+            computeBarrier(cmd);
+
+            dispatch(cmd, Kernel::RadixScatter,
+                    { &sourceKeys, &sourceValues, &destinationKeys, &destinationValues, &counts },
+                    &constants, sizeof(RadixConstants), groupCount);
+
+            if (pass + 1 < passes)
+                computeBarrier(cmd);
+        }
+    }
+
+    void GpuPrimitives::histogram(VkCommandBuffer cmd, const Buffer& values, const Buffer& bins,
+            uint32_t count, uint32_t binCount, bool accumulate)
+    {
+        if (count == 0 || !checkCount(count, c_BlockSize))
+            return;
+
+        BarrierBatcher barriers;
+        barriers.memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                VK_ACCESS_2_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_SHADER_READ_BIT |
+                VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+        if (!accumulate)
+        {
+            barriers.flush(cmd);
+
+            vkCmdFillBuffer(cmd, bins.buffer, 0, binCount * sizeof(uint32_t), 0);
+
+            barriers.bufferBarrier(bins, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                    VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+        }
+
+        barriers.flush(cmd);
+
+        HistogramConstants constants{ count, binCount };
+        dispatch(cmd, Kernel::Histogram, { &values, &bins }, &constants,
+                sizeof(HistogramConstants), divideRoundUp(count, c_BlockSize));
+    }
+
+    DescriptorBuilder GpuPrimitives::createDescriptorBuilder()
+    {
+        return m_UsePushDescriptors ? Engine::get()->createPushDescriptorBuilder() :
+            Engine::get()->createFrameDescriptorBuilder();
+    }
+
+    VkPipeline GpuPrimitives::getPipeline(Kernel kernel, ReduceOp op)
+    {
+        uint32_t key = static_cast<uint32_t>(kernel) | (static_cast<uint32_t>(op) << 8) |
+            (m_UseSubgroups ? 1 << 16 : 0);
+
+        auto it = m_Pipelines.find(key);
+        if (it != m_Pipelines.end())
+            return it->second;
+
+        const KernelInfo& info = c_Kernels[static_cast<uint32_t>(kernel)];
+        std::string path = m_ShaderDirectory +
+            (m_UseSubgroups ? info.subgroup : info.generic) + ".comp.spv";
+
+        SpecializationConstants constants;
+        constants.set(0, c_WorkgroupSize)
+            .set(1, info.itemsPerThread);
+
+        if (kernel == Kernel::Reduce)
+            constants.set(2, static_cast<uint32_t>(op));
+
+        ComputeShader shader;
+        shader.addShaderModule(path.c_str());
+        shader.setSpecialization(constants);
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        Engine::get()->createComputePipelineBuilder()
+            .setShader(shader)
+            .build(pipeline, m_PipelineLayout);
+
+        m_Pipelines[key] = pipeline;
+        return pipeline;
+    }
+
+    Buffer& GpuPrimitives::getScratch(uint32_t slot, VkDeviceSize size)
+    {
+        auto it = m_Scratch.find(slot);
+        if (it != m_Scratch.end())
+        {
+            if (it->second.size >= size)
+                return it->second;
+
+            m_Retired.push_back(it->second);
+            m_Scratch.erase(it);
+        }
+
+        // Rounded up so a slowly growing count does not replace it every call
+        VkDeviceSize allocationSize = 256;
+        while (allocationSize < size)
+            allocationSize *= 2;
+
+        Buffer& buffer = m_Scratch[slot];
+        buffer.create(allocationSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY);
+
+        return buffer;
+    }
+
+    void GpuPrimitives::dispatch(VkCommandBuffer cmd, Kernel kernel,
+            std::array<const Buffer*, c_Bindings> buffers,
+            const void* constants, uint32_t constantsSize, uint32_t groupCount, ReduceOp op)
+    {
+        std::array<VkDescriptorBufferInfo, c_Bindings> bufferInfos;
+
+        DescriptorBuilder builder = createDescriptorBuilder();
+        for (uint32_t i = 0; i < c_Bindings; i++)
+        {
+            const Buffer* buffer = buffers[i] ? buffers[i] : buffers[0];
+
+            bufferInfos[i].buffer = buffer->buffer;
+            bufferInfos[i].offset = 0;
+            bufferInfos[i].range = VK_WHOLE_SIZE;
+
+            builder.bindBuffer(i, &bufferInfos[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    VK_SHADER_STAGE_COMPUTE_BIT);
+        }
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, getPipeline(kernel, op));
+
+        if (m_UsePushDescriptors)
+        {
+            builder.push(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0);
+        }
+        else
+        {
+            VkDescriptorSet set;
+            builder.build(set);
+
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout,
+                    0, 1, &set, 0, nullptr);
+        }
+        vkCmdPushConstants(cmd, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                constantsSize, constants);
+
+        vkCmdDispatch(cmd, groupCount, 1, 1);
+    }
+
+    void GpuPrimitives::scan(VkCommandBuffer cmd, const Buffer& input, const Buffer& output,
+            uint32_t count, bool exclusive, uint32_t level)
+    {
+        uint32_t blockCount = divideRoundUp(count, c_BlockSize);
+
+        ScanConstants constants{ count, exclusive ? 1u : 0u, blockCount > 1 ? 1u : 0u };
+
+        if (blockCount == 1)
+        {
+            dispatch(cmd, Kernel::Scan, { &input, &output, &output }, &constants,
+                    sizeof(ScanConstants), 1);
+            return;
+        }
+
+        // Scan each block, then the block sums, then add those back
+        Buffer& blockSums = getScratch(c_ScanSlot + level, blockCount * sizeof(uint32_t));
+
+        dispatch(cmd, Kernel::Scan, { &input, &output, &blockSums }, &constants,
+                sizeof(ScanConstants), blockCount);
+
+        computeBarrier(cmd);
+        scan(cmd, blockSums, blockSums, blockCount, true, level + 1);
+        computeBarrier(cmd);
+
+        dispatch(cmd, Kernel::ScanAdd, { &output, &output, &blockSums }, &count,
+                sizeof(uint32_t), blockCount);
+    }
+
+    bool GpuPrimitives::checkCount(uint32_t count, uint32_t itemsPerGroup)
+    {
+        if (divideRoundUp(count, itemsPerGroup) <= c_MaxGroupCount)
+            return true;
+
+        EOS_CORE_LOG_ERROR("{} elements are too many for a GPU primitive, the limit is {}",
+                count, c_MaxGroupCount * itemsPerGroup);
+        return false;
+    }
+
+    void GpuPrimitives::computeBarrier(VkCommandBuffer cmd)
+    {
+        BarrierBatcher()
+            .memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT)
+            .flush(cmd);
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/DescriptorSets/DescriptorBuilder.hpp"
+
+#include <array>
+#include <map>
+#include <string>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    enum class ReduceOp : uint32_t
+    {
+        Add = 0,
+        Min,
+        Max
+    };
+
+    // Compute kernels over buffers of uint32_t, loaded from the SPIR-V built
+    // from eos/Eos/Shaders. Every call records into cmd: inputs have to be
+    // visible to compute shader reads beforehand and the results are written
+    // by the compute stage. Buffers need VK_BUFFER_USAGE_STORAGE_BUFFER_BIT.
+    // Nothing is recorded for a count of 0, or a count too large to dispatch.
+    //
+    // Calls share scratch buffers, so command buffers recorded with them must
+    // not execute at the same time. Without push descriptors the sets come
+    // from the frame allocator, so cmd has to be submitted in the current frame
+    class EOS_API GpuPrimitives
+    {
+    public:
+        void init(const std::string& shaderDirectory = "res/Eos/Shaders/");
+        void cleanup();
+
+        // Writes the result to the first element of output
+        void reduce(VkCommandBuffer cmd, const Buffer& input, const Buffer& output,
+                uint32_t count, ReduceOp op = ReduceOp::Add);
+
+        // input and output may be the same buffer
+        void inclusiveScan(VkCommandBuffer cmd, const Buffer& input, const Buffer& output,
+                uint32_t count);
+        void exclusiveScan(VkCommandBuffer cmd, const Buffer& input, const Buffer& output,
+                uint32_t count);
+
+        // Keeps the values with a non zero flag, in order. The number kept is
+        // written to the first element of countOutput
+        void compact(VkCommandBuffer cmd, const Buffer& values, const Buffer& flags,
+                const Buffer& output, const Buffer& countOutput, uint32_t count);
+
+        // Stable sort of keys, values are moved with their key. keyBits is
+        // rounded up to a multiple of 8 so the result ends in the same buffers
+        void radixSort(VkCommandBuffer cmd, const Buffer& keys, const Buffer& values,
+                uint32_t count, uint32_t keyBits = 32);
+
+        // Values are bin indices, values of binCount and above are skipped.
+        // bins needs VK_BUFFER_USAGE_TRANSFER_DST_BIT unless accumulating
+        void histogram(VkCommandBuffer cmd, const Buffer& values, const Buffer& bins,
+                uint32_t count, uint32_t binCount, bool accumulate = false);
+
+        bool subgroupsSupported() const { return m_SubgroupsSupported; }
+        bool usesSubgroups() const { return m_UseSubgroups; }
+
+        // Switches to the shared memory kernels, ignored when subgroup
+        // arithmetic is not supported
+        void setUseSubgroups(bool use) { m_UseSubgroups = use && m_SubgroupsSupported; }
+    private:
+        enum class Kernel : uint32_t
+        {
+            Reduce = 0,
+            Scan,
+            ScanAdd,
+            Compact,
+            RadixHistogram,
+            RadixScatter,
+            Histogram
+        };
+
+        static constexpr uint32_t c_Bindings = 5;
+
+        std::string m_ShaderDirectory;
+
+        bool m_SubgroupsSupported = false;
+        bool m_UseSubgroups = false;
+        bool m_UsePushDescriptors = false;
+
+        VkDescriptorSetLayout m_SetLayout;
+        VkPipelineLayout m_PipelineLayout;
+
+        std::unordered_map<uint32_t, VkPipeline> m_Pipelines;
+
+        // Slots are grown, never shrunk. Replaced buffers can still be in use
+        // by recorded work, so they are only destroyed in cleanup
+        std::map<uint32_t, Buffer> m_Scratch;
+        std::vector<Buffer> m_Retired;
+    private:
+        DescriptorBuilder createDescriptorBuilder();
+        VkPipeline getPipeline(Kernel kernel, ReduceOp op = ReduceOp::Add);
+        Buffer& getScratch(uint32_t slot, VkDeviceSize size);
+
+        void dispatch(VkCommandBuffer cmd, Kernel kernel,
+                std::array<const Buffer*, c_Bindings> buffers,
+                const void* constants, uint32_t constantsSize, uint32_t groupCount,
+                ReduceOp op = ReduceOp::Add);
+
+        void scan(VkCommandBuffer cmd, const Buffer& input, const Buffer& output,
+                uint32_t count, bool exclusive, uint32_t level = 0);
+
+        // Logs an error when count needs more workgroups than can be dispatched
+        static bool checkCount(uint32_t count, uint32_t itemsPerGroup);
+        static void computeBarrier(VkCommandBuffer cmd);
+    };
+}
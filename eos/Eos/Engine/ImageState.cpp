@@ -0,0 +1,237 @@
+#include "ImageState.hpp"
+
+namespace Eos
+{
+    void ImageState::init(uint32_t mipLevels, uint32_t arrayLayers, const ImageAccess& access)
+    {
+        m_MipLevels = mipLevels;
+        m_ArrayLayers = arrayLayers;
+
+        m_States.assign(static_cast<size_t>(mipLevels) * arrayLayers, getState(access));
+    }
+
+    const ImageAccess& ImageState::get(uint32_t level, uint32_t layer) const
+    {
+        return m_States[static_cast<size_t>(level) * m_ArrayLayers + layer].access;
+    }
+
+    void ImageState::set(const VkImageSubresourceRange& range, const ImageAccess& access)
+    {
+        setState(range, getState(access));
+    }
+
+    void ImageState::setState(const VkImageSubresourceRange& range, const State& state)
+    {
+        VkImageSubresourceRange resolved = resolveRange(range);
+
+        for (uint32_t level = resolved.baseMipLevel;
+                level < resolved.baseMipLevel + resolved.levelCount; level++)
+        {
+            for (uint32_t layer = resolved.baseArrayLayer;
+                    layer < resolved.baseArrayLayer + resolved.layerCount; layer++)
+            {
+                m_States[static_cast<size_t>(level) * m_ArrayLayers + layer] = state;
+            }
+        }
+    }
+
+    void ImageState::set(const ImageAccess& access)
+    {
+        m_States.assign(m_States.size(), getState(access));
+    }
+
+    std::vector<ImageState::Range> ImageState::getRanges(
+            const VkImageSubresourceRange& range) const
+    {
+        VkImageSubresourceRange resolved = resolveRange(range);
+
+        std::vector<Range> ranges;
+        std::vector<Range> levelRanges;
+
+        for (uint32_t level = resolved.baseMipLevel;
+                level < resolved.baseMipLevel + resolved.levelCount; level++)
+        {
+            // Runs of neighbouring layers with the same state
+            levelRanges.clear();
+            for (uint32_t layer = resolved.baseArrayLayer;
+                    layer < resolved.baseArrayLayer + resolved.layerCount; layer++)
+            {
+                const State& state = m_States[static_cast<size_t>(level) * m_ArrayLayers + layer];
+
+                if (!levelRanges.empty() && levelRanges.back().access == state.access &&
+                        levelRanges.back().writeStage == state.writeStage &&
+                        levelRanges.back().writeAccess == state.writeAccess)
+                {
+                    levelRanges.back().range.layerCount++;
+                    continue;
+                }
+
+                Range layerRange;
+                layerRange.range = { resolved.aspectMask, level, 1, layer, 1 };
+                layerRange.access = state.access;
+                layerRange.writeStage = state.writeStage;
+                layerRange.writeAccess = state.writeAccess;
+                levelRanges.push_back(layerRange);
+            }
+
+            // Extend a run from the level above when it covers the same layers
+            for (const Range& layerRange : levelRanges)
+            {
+                bool merged = false;
+                for (Range& existing : ranges)
+                {
+                    if (existing.range.baseMipLevel + existing.range.levelCount == level &&
+                            existing.range.baseArrayLayer == layerRange.range.baseArrayLayer &&
+                            existing.range.layerCount == layerRange.range.layerCount &&
+                            existing.access == layerRange.access &&
+                            existing.writeStage == layerRange.writeStage &&
+                            existing.writeAccess == layerRange.writeAccess)
+                    {
+                        existing.range.levelCount++;
+                        merged = true;
+                        break;
+                    }
+                }
+
+                if (!merged)
+                    ranges.push_back(layerRange);
+            }
+        }
+
+        return ranges;
+    }
+
+    // Calls function with every block of range that needs a barrier, along
+    // with the state to wait on, and records access as the new state
+    template<typename Function>
+    void ImageState::visitTransitions(const VkImageSubresourceRange& range,
+            const ImageAccess& access, Function function)
+    {
+        for (const Range& current : getRanges(range))
+        {
+            const ImageAccess& previous = current.access;
+
+            // Reads in the same layout can overlap, the readers are kept so
+            // that a later write waits for all of them. A reader the last
+            // write was not made visible to waits on that write's scope
+            if (previous.layout == access.layout && previous.layout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                    !isWriteAccess(previous.access) && !isWriteAccess(access.access))
+            {
+                if ((access.stage & ~previous.stage) != 0 ||
+                        (access.access & ~previous.access) != 0)
+                {
+                    function(current.range, ImageAccess{ previous.layout, current.writeAccess,
+                            current.writeStage });
+                }
+
+                setState(current.range, { { access.layout, previous.access | access.access,
+                        previous.stage | access.stage }, current.writeStage,
+                        current.writeAccess });
+                continue;
+            }
+
+            function(current.range, previous);
+
+            // A write is waited on directly. After a transition between read
+            // layouts, later readers chain through the stages waiting on it
+            if (isWriteAccess(previous.access) && !isWriteAccess(access.access))
+                setState(current.range, { access, previous.stage, previous.access });
+            else
+                setState(current.range, getState(access));
+        }
+    }
+
+    // Only writes have to be made available, reads just need to finish
+    static VkAccessFlags getAvailableAccess(VkAccessFlags access)
+    {
+        return access & ~(VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
+                VK_ACCESS_MEMORY_READ_BIT);
+    }
+
+    VkPipelineStageFlags ImageState::getBarriers(VkImage image,
+            const VkImageSubresourceRange& range, const ImageAccess& access,
+            std::vector<VkImageMemoryBarrier>& barriers)
+    {
+        VkPipelineStageFlags srcStages = 0;
+
+        visitTransitions(range, access,
+            [&](const VkImageSubresourceRange& subresources, const ImageAccess& previous) {
+                VkImageMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                barrier.pNext = nullptr;
+                barrier.oldLayout = previous.layout;
+                barrier.newLayout = access.layout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = image;
+                barrier.subresourceRange = subresources;
+                barrier.srcAccessMask = getAvailableAccess(previous.access);
+                barrier.dstAccessMask = access.access;
+
+                barriers.push_back(barrier);
+                srcStages |= previous.stage;
+            });
+
+        return srcStages;
+    }
+
+    void ImageState::getBarriers(VkImage image, const VkImageSubresourceRange& range,
+            const ImageAccess& access, std::vector<VkImageMemoryBarrier2>& barriers)
+    {
+        visitTransitions(range, access,
+            [&](const VkImageSubresourceRange& subresources, const ImageAccess& previous) {
+                // The original flags keep their values in the 64 bit versions
+                VkImageMemoryBarrier2 barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                barrier.pNext = nullptr;
+                barrier.srcStageMask = previous.stage;
+                barrier.srcAccessMask = getAvailableAccess(previous.access);
+                barrier.dstStageMask = access.stage;
+                barrier.dstAccessMask = access.access;
+                barrier.oldLayout = previous.layout;
+                barrier.newLayout = access.layout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = image;
+                barrier.subresourceRange = subresources;
+
+                barriers.push_back(barrier);
+            });
+    }
+
+    bool ImageState::isUniform() const
+    {
+        for (const State& state : m_States)
+        {
+            if (!(state == m_States.front()))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool ImageState::isWriteAccess(VkAccessFlags access)
+    {
+        return access & (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+    }
+
+    ImageState::State ImageState::getState(const ImageAccess& access)
+    {
+        return { access, access.stage, isWriteAccess(access.access) ? access.access : 0 };
+    }
+
+    VkImageSubresourceRange ImageState::resolveRange(const VkImageSubresourceRange& range) const
+    {
+        VkImageSubresourceRange resolved = range;
+
+        if (resolved.levelCount == VK_REMAINING_MIP_LEVELS)
+            resolved.levelCount = m_MipLevels - resolved.baseMipLevel;
+        if (resolved.layerCount == VK_REMAINING_ARRAY_LAYERS)
+            resolved.layerCount = m_ArrayLayers - resolved.baseArrayLayer;
+
+        return resolved;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    struct ImageAccess
+    {
+        VkImageLayout layout;
+        VkAccessFlags access;
+        VkPipelineStageFlags stage;
+
+        bool operator==(const ImageAccess& other) const
+        {
+            return layout == other.layout && access == other.access && stage == other.stage;
+        }
+    };
+
+    // Common ways an image is used, pass these to Texture2D::transition
+    namespace Access
+    {
+        inline constexpr ImageAccess Undefined = { VK_IMAGE_LAYOUT_UNDEFINED, 0,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT };
+
+        inline constexpr ImageAccess TransferSrc = { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT };
+        inline constexpr ImageAccess TransferDst = { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT };
+
+        inline constexpr ImageAccess FragmentShaderRead = {
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT };
+        inline constexpr ImageAccess ComputeShaderRead = {
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT };
+
+        inline constexpr ImageAccess ComputeShaderWrite = { VK_IMAGE_LAYOUT_GENERAL,
+            VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT };
+        inline constexpr ImageAccess ComputeShaderReadWrite = { VK_IMAGE_LAYOUT_GENERAL,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT };
+
+        inline constexpr ImageAccess ColourAttachment = {
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    }
+
+    // Tracks the last access of every mip level and array layer of an image
+    class EOS_API ImageState
+    {
+    public:
+        struct Range
+        {
+            VkImageSubresourceRange range;
+            ImageAccess access;
+
+            // Scope of the last write or layout transition. Readers outside
+            // access have not seen it yet and wait on this scope
+            VkPipelineStageFlags writeStage;
+            VkAccessFlags writeAccess;
+        };
+
+    public:
+        void init(uint32_t mipLevels, uint32_t arrayLayers,
+                const ImageAccess& access = Access::Undefined);
+
+        const ImageAccess& get(uint32_t level, uint32_t layer) const;
+        void set(const VkImageSubresourceRange& range, const ImageAccess& access);
+        void set(const ImageAccess& access);
+
+        // Splits range into the largest blocks sharing the same state
+        std::vector<Range> getRanges(const VkImageSubresourceRange& range) const;
+
+        // Appends the barriers needed before range can be used with access
+        // and records access as the new state. Reads in the same layout only
+        // get a barrier when the last write was not yet made visible to their
+        // stage and access. Returns the source stages to wait on
+        VkPipelineStageFlags getBarriers(VkImage image, const VkImageSubresourceRange& range,
+                const ImageAccess& access, std::vector<VkImageMemoryBarrier>& barriers);
+        void getBarriers(VkImage image, const VkImageSubresourceRange& range,
+                const ImageAccess& access, std::vector<VkImageMemoryBarrier2>& barriers);
+
+        // Valid when every subresource shares the same state
+        bool isUniform() const;
+
+        uint32_t getMipLevels() const { return m_MipLevels; }
+        uint32_t getArrayLayers() const { return m_ArrayLayers; }
+
+        static bool isWriteAccess(VkAccessFlags access);
+    private:
+        struct State
+        {
+            ImageAccess access;
+            VkPipelineStageFlags writeStage;
+            VkAccessFlags writeAccess;
+
+            bool operator==(const State& other) const
+            {
+                return access == other.access && writeStage == other.writeStage &&
+                    writeAccess == other.writeAccess;
+            }
+        };
+
+        std::vector<State> m_States;
+
+        uint32_t m_MipLevels = 0;
+        uint32_t m_ArrayLayers = 0;
+    private:
+        VkImageSubresourceRange resolveRange(const VkImageSubresourceRange& range) const;
+        void setState(const VkImageSubresourceRange& range, const State& state);
+
+        template<typename Function>
+        void visitTransitions(const VkImageSubresourceRange& range, const ImageAccess& access,
+                Function function);
+
+        static State getState(const ImageAccess& access);
+    };
+}
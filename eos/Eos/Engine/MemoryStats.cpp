@@ -0,0 +1,240 @@
+#include "MemoryStats.hpp"
+
+#include <fstream>
+
+namespace Eos
+{
+    static float toMiB(VkDeviceSize bytes)
+    {
+        return static_cast<float>(bytes) / (1024.0f * 1024.0f);
+    }
+
+    void MemoryStats::init(VmaAllocator allocator)
+    {
+        m_Allocator = allocator;
+
+        nextFrame();
+    }
+
+    void MemoryStats::track(MemoryCategory category, VmaAllocation allocation)
+    {
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(m_Allocator, allocation, &allocationInfo);
+
+        // Shows up in the VMA JSON dump next to each allocation
+        vmaSetAllocationName(m_Allocator, allocation, getCategoryName(category));
+
+        track(category, reinterpret_cast<uint64_t>(allocation), allocationInfo.size);
+    }
+
+    void MemoryStats::track(MemoryCategory category, uint64_t handle, VkDeviceSize size)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Allocations[handle] = { category, size };
+
+        size_t index = static_cast<size_t>(category);
+        m_Categories[index].count++;
+        m_Categories[index].bytes += size;
+
+        m_CurrentFrame[index].allocations++;
+        m_CurrentFrame[index].allocatedBytes += size;
+    }
+
+    void MemoryStats::untrack(VmaAllocation allocation)
+    {
+        untrack(reinterpret_cast<uint64_t>(allocation));
+    }
+
+    void MemoryStats::untrack(uint64_t handle)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Allocations.find(handle);
+        if (it == m_Allocations.end())
+            return;
+
+        size_t index = static_cast<size_t>(it->second.category);
+        m_Categories[index].count--;
+        m_Categories[index].bytes -= it->second.size;
+
+        m_CurrentFrame[index].frees++;
+        m_CurrentFrame[index].freedBytes += it->second.size;
+
+        m_Allocations.erase(it);
+    }
+
+    void MemoryStats::nextFrame()
+    {
+        const VkPhysicalDeviceMemoryProperties* memoryProperties;
+        vmaGetMemoryProperties(m_Allocator, &memoryProperties);
+
+        std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+        vmaGetHeapBudgets(m_Allocator, budgets.data());
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_LastFrame = m_CurrentFrame;
+        m_CurrentFrame.fill(FrameDelta());
+
+        m_HeapBudgets = std::move(budgets);
+    }
+
+    MemoryStats::CategoryStatistics MemoryStats::getCategory(MemoryCategory category)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        return m_Categories[static_cast<size_t>(category)];
+    }
+
+    MemoryStats::FrameDelta MemoryStats::getFrameDelta(MemoryCategory category)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        return m_LastFrame[static_cast<size_t>(category)];
+    }
+
+    std::vector<VmaBudget> MemoryStats::getHeapBudgets()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        return m_HeapBudgets;
+    }
+
+    void MemoryStats::drawImGui(bool* open)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (!ImGui::Begin("Memory", open))
+        {
+            ImGui::End();
+            return;
+        }
+
+        if (ImGui::CollapsingHeader("Heaps", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            for (size_t i = 0; i < m_HeapBudgets.size(); i++)
+            {
+                const VmaBudget& budget = m_HeapBudgets[i];
+                if (budget.budget == 0)
+                    continue;
+
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "%.1f / %.1f MiB", toMiB(budget.usage),
+                        toMiB(budget.budget));
+
+                ImGui::Text("Heap %zu", i);
+                ImGui::SameLine();
+                ImGui::ProgressBar(static_cast<float>(budget.usage) / budget.budget,
+                        ImVec2(-1, 0), overlay);
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Categories", ImGuiTreeNodeFlags_DefaultOpen) &&
+                ImGui::BeginTable("MemoryCategories", 5,
+                    ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Category");
+            ImGui::TableSetupColumn("Count");
+            ImGui::TableSetupColumn("MiB");
+            ImGui::TableSetupColumn("Allocs / Frees");
+            ImGui::TableSetupColumn("Churn MiB");
+            ImGui::TableHeadersRow();
+
+            for (size_t i = 0; i < s_CategoryCount; i++)
+            {
+                const CategoryStatistics& category = m_Categories[i];
+                const FrameDelta& delta = m_LastFrame[i];
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(getCategoryName(static_cast<MemoryCategory>(i)));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", category.count);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", toMiB(category.bytes));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u / %u", delta.allocations, delta.frees);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", toMiB(delta.allocatedBytes + delta.freedBytes));
+            }
+
+            ImGui::EndTable();
+        }
+
+        ImGui::End();
+    }
+
+    bool MemoryStats::dumpJSON(const char* file)
+    {
+        std::ofstream output(file);
+        if (!output.is_open())
+        {
+            EOS_CORE_LOG_ERROR("Failed to open {} for the memory dump", file);
+            return false;
+        }
+
+        char* vmaStats;
+        vmaBuildStatsString(m_Allocator, &vmaStats, VK_TRUE);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            output << "{\n\t\"Categories\": {";
+            for (size_t i = 0; i < s_CategoryCount; i++)
+            {
+                const CategoryStatistics& category = m_Categories[i];
+                const FrameDelta& delta = m_LastFrame[i];
+
+                output << (i == 0 ? "\n" : ",\n");
+                output << "\t\t\"" << getCategoryName(static_cast<MemoryCategory>(i)) << "\": { "
+                    << "\"Count\": " << category.count << ", "
+                    << "\"Bytes\": " << category.bytes << ", "
+                    << "\"FrameAllocations\": " << delta.allocations << ", "
+                    << "\"FrameFrees\": " << delta.frees << ", "
+                    << "\"FrameAllocatedBytes\": " << delta.allocatedBytes << ", "
+                    << "\"FrameFreedBytes\": " << delta.freedBytes << " }";
+            }
+            output << "\n\t},\n";
+        }
+
+        output << "\t\"Vma\": " << vmaStats << "\n}\n";
+
+        vmaFreeStatsString(m_Allocator, vmaStats);
+
+        EOS_CORE_LOG_INFO("Wrote memory statistics to {}", file);
+        return true;
+    }
+
+    const char* MemoryStats::getCategoryName(MemoryCategory category)
+    {
+        switch (category)
+        {
+            case MemoryCategory::Mesh: return "Mesh";
+            case MemoryCategory::Texture: return "Texture";
+            case MemoryCategory::Staging: return "Staging";
+            case MemoryCategory::Uniform: return "Uniform";
+            case MemoryCategory::Storage: return "Storage";
+            case MemoryCategory::DescriptorPool: return "DescriptorPool";
+            default: return "Other";
+        }
+    }
+
+    MemoryCategory MemoryStats::getBufferCategory(VkBufferUsageFlags usage,
+            VmaMemoryUsage memoryUsage)
+    {
+        if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT))
+            return MemoryCategory::Mesh;
+
+        if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+            return MemoryCategory::Uniform;
+
+        if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+            return MemoryCategory::Storage;
+
+        if (memoryUsage == VMA_MEMORY_USAGE_CPU_ONLY && (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
+            return MemoryCategory::Staging;
+
+        return MemoryCategory::Other;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <array>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+namespace Eos
+{
+    enum class MemoryCategory
+    {
+        Mesh,
+        Texture,
+        Staging,
+        Uniform,
+        Storage,
+        DescriptorPool,
+        Other,
+
+        Count
+    };
+
+    // Tracks engine allocations by category on top of the VMA statistics.
+    // Counters are live, deltas cover the last completed frame
+    class EOS_API MemoryStats
+    {
+    public:
+        struct CategoryStatistics
+        {
+            uint32_t count = 0;
+            VkDeviceSize bytes = 0;
+        };
+
+        struct FrameDelta
+        {
+            uint32_t allocations = 0;
+            uint32_t frees = 0;
+            VkDeviceSize allocatedBytes = 0;
+            VkDeviceSize freedBytes = 0;
+        };
+
+    public:
+        void init(VmaAllocator allocator);
+
+        void track(MemoryCategory category, VmaAllocation allocation);
+        void track(MemoryCategory category, uint64_t handle, VkDeviceSize size);
+
+        void untrack(VmaAllocation allocation);
+        void untrack(uint64_t handle);
+
+        // Ends the current frame's deltas and refreshes the heap budgets
+        void nextFrame();
+
+        CategoryStatistics getCategory(MemoryCategory category);
+        FrameDelta getFrameDelta(MemoryCategory category);
+
+        std::vector<VmaBudget> getHeapBudgets();
+
+        void drawImGui(bool* open = nullptr);
+
+        // Writes the category counters together with VMA's detailed map
+        bool dumpJSON(const char* file);
+
+        static const char* getCategoryName(MemoryCategory category);
+        static MemoryCategory getBufferCategory(VkBufferUsageFlags usage,
+                VmaMemoryUsage memoryUsage);
+    private:
+        struct TrackedAllocation
+        {
+            MemoryCategory category;
+            VkDeviceSize size;
+        };
+
+        static const size_t s_CategoryCount = static_cast<size_t>(MemoryCategory::Count);
+
+        std::unordered_map<uint64_t, TrackedAllocation> m_Allocations;
+
+        std::array<CategoryStatistics, s_CategoryCount> m_Categories;
+        std::array<FrameDelta, s_CategoryCount> m_CurrentFrame;
+        std::array<FrameDelta, s_CategoryCount> m_LastFrame;
+
+        std::vector<VmaBudget> m_HeapBudgets;
+
+        std::mutex m_Mutex;
+
+        VmaAllocator m_Allocator;
+    };
+}
@@ -69,12 +69,10 @@ namespace Eos
                     });
 
             m_DeletionQueue.pushFunction([=]() {
-                vmaDestroyBuffer(GlobalData::getAllocator(), m_VertexBuffer.buffer,
-                        m_VertexBuffer.allocation);
+                m_VertexBuffer.destroy();
             });
 
-            vmaDestroyBuffer(GlobalData::getAllocator(), stagingBuffer.buffer,
-                    stagingBuffer.allocation);
+            stagingBuffer.destroy();
         }
 
     protected:
@@ -129,12 +127,10 @@ namespace Eos
                     });
 
             Mesh<T>::m_DeletionQueue.pushFunction([=]() {
-                vmaDestroyBuffer(GlobalData::getAllocator(), m_IndexBuffer.buffer,
-                        m_IndexBuffer.allocation);
+                m_IndexBuffer.destroy();
             });
 
-            vmaDestroyBuffer(GlobalData::getAllocator(), stagingBuffer.buffer,
-                    stagingBuffer.allocation);
+            stagingBuffer.destroy();
         }
 
     private:
@@ -1,27 +1,96 @@
 #include "ComputePipelineBuilder.hpp"
 #include <vulkan/vulkan_core.h>
 
+#include "Eos/Core/Hash.hpp"
+#include "Eos/Engine/ComputeShader.hpp"
+
 namespace Eos
 {
     DeletionQueue ComputePipelineBuilder::s_DeletionQueue;
 
-    ComputePipelineBuilder ComputePipelineBuilder::begin(VkDevice* device)
+    std::unordered_map<ComputePipelineBuilder::PipelineKey, VkPipeline,
+        ComputePipelineBuilder::PipelineKeyHash> ComputePipelineBuilder::s_Cache;
+    ComputePipelineBuilder::Statistics ComputePipelineBuilder::s_Statistics;
+    std::mutex ComputePipelineBuilder::s_Mutex;
+
+    bool ComputePipelineBuilder::PipelineKey::operator==(const PipelineKey& other) const
+    {
+        if (other.codeHash != codeHash || other.layout != layout || other.flags != flags ||
+                other.entryPoint != entryPoint || !(other.specialization == specialization))
+            return false;
+
+        // The hash only narrows the search, equal hashes can still be different code
+        return other.code == code || *other.code == *code;
+    }
+
+    size_t ComputePipelineBuilder::PipelineKey::hash() const
+    {
+        size_t result = 0;
+        hashCombine(result, codeHash);
+        hashCombine(result, std::hash<std::string>()(entryPoint));
+        hashCombine(result, specialization.hash());
+        hashCombine(result, reinterpret_cast<uint64_t>(layout));
+        hashCombine(result, flags);
+
+        return result;
+    }
+
+    ComputePipelineBuilder ComputePipelineBuilder::begin(VkDevice* device,
+            PipelineLayoutCache* layoutCache)
     {
         ComputePipelineBuilder pipeline;
         pipeline.m_Device = device;
+        pipeline.m_LayoutCache = layoutCache;
 
         return pipeline;
     }
 
     void ComputePipelineBuilder::cleanup()
     {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+
         s_DeletionQueue.flush();
+
+        s_Cache.clear();
+        s_Statistics = Statistics{};
+    }
+
+    ComputePipelineBuilder::Statistics ComputePipelineBuilder::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+
+        Statistics statistics = s_Statistics;
+        statistics.size = s_Cache.size();
+        return statistics;
+    }
+
+    ComputePipelineBuilder& ComputePipelineBuilder::setShader(const ComputeShader& shader)
+    {
+        m_ShaderStage = const_cast<ComputeShader&>(shader).getShaderStage();
+        m_CodeHash = shader.getCodeHash();
+        m_Code = shader.getCode();
+
+        if (!m_OverrideSpecialization)
+            m_Specialization = shader.getSpecialization();
+
+        return *this;
     }
 
     ComputePipelineBuilder& ComputePipelineBuilder::setShaderStage(
             VkPipelineShaderStageCreateInfo& stage)
     {
         m_ShaderStage = stage;
+        m_CodeHash = 0;
+        m_Code.reset();
+
+        return *this;
+    }
+
+    ComputePipelineBuilder& ComputePipelineBuilder::setSpecialization(
+            const SpecializationConstants& constants)
+    {
+        m_Specialization = constants;
+        m_OverrideSpecialization = true;
 
         return *this;
     }
@@ -42,11 +111,24 @@ namespace Eos
     ComputePipelineBuilder& ComputePipelineBuilder::createPipelineLayout(VkPipelineLayout& layout,
             const VkPipelineLayoutCreateInfo& layoutCI)
     {
+        if (m_LayoutCache)
+        {
+            layout = m_LayoutCache->createPipelineLayout(&layoutCI);
+            return *this;
+        }
+
         if (vkCreatePipelineLayout(*m_Device, &layoutCI, nullptr, &layout) != VK_SUCCESS)
         {
             EOS_CORE_LOG_CRITICAL("Failed to create Pipeline Layout");
+            return *this;
         }
 
+        VkDevice tempDevice = *m_Device;
+        VkPipelineLayout tempLayout = layout;
+        s_DeletionQueue.pushFunction([=]() {
+            vkDestroyPipelineLayout(tempDevice, tempLayout, nullptr);
+        });
+
         return *this;
     }
 
@@ -63,9 +145,31 @@ namespace Eos
         VkComputePipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
         pipelineInfo.pNext = nullptr;
+        pipelineInfo.flags = m_Flags;
         pipelineInfo.stage = m_ShaderStage;
         pipelineInfo.layout = layout;
 
+        if (m_Code || m_OverrideSpecialization)
+            pipelineInfo.stage.pSpecializationInfo = m_Specialization.getInfo();
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+
+        PipelineKey key;
+        if (m_Code)
+        {
+            key = { m_CodeHash, m_Code, m_ShaderStage.pName, m_Specialization, layout, m_Flags };
+
+            auto it = s_Cache.find(key);
+            if (it != s_Cache.end())
+            {
+                s_Statistics.hits++;
+                pipeline = it->second;
+                return true;
+            }
+
+            s_Statistics.misses++;
+        }
+
         if (vkCreateComputePipelines(*m_Device, VK_NULL_HANDLE, 1, &pipelineInfo,
                     nullptr, &pipeline) != VK_SUCCESS)
         {
@@ -73,10 +177,13 @@ namespace Eos
             return false;
         }
 
+        if (m_Code)
+            s_Cache[key] = pipeline;
+
         VkDevice tempDevice = *m_Device;
+        VkPipeline tempPipeline = pipeline;
         s_DeletionQueue.pushFunction([=]() {
-            vkDestroyPipelineLayout(tempDevice, layout, nullptr);
-            vkDestroyPipeline(tempDevice, pipeline, nullptr);
+            vkDestroyPipeline(tempDevice, tempPipeline, nullptr);
         });
 
         EOS_CORE_LOG_INFO("Built Compute Pipeline");
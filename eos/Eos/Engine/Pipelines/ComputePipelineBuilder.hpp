@@ -3,21 +3,43 @@
 #include "Eos/EosPCH.hpp"
 
 #include "Eos/Engine/Pipelines/PipelineCreationInfo.hpp"
+#include "Eos/Engine/Pipelines/PipelineLayoutCache.hpp"
+#include "Eos/Engine/Pipelines/SpecializationConstants.hpp"
 
 #include "Eos/Core/DeletionQueue.hpp"
 
+#include <mutex>
+#include <string>
+
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_core.h>
 
 namespace Eos
 {
+    class ComputeShader;
+
     class EOS_API ComputePipelineBuilder
     {
     public:
-        static ComputePipelineBuilder begin(VkDevice* device);
+        struct Statistics
+        {
+            uint32_t hits = 0;
+            uint32_t misses = 0;
+            size_t size = 0;
+        };
+
+    public:
+        static ComputePipelineBuilder begin(VkDevice* device,
+                PipelineLayoutCache* layoutCache = nullptr);
         static void cleanup();
 
+        static Statistics getStatistics();
+
+        // Pipelines built from a ComputeShader are cached on its code, entry
+        // point, specialization constants, layout and flags
+        ComputePipelineBuilder& setShader(const ComputeShader& shader);
         ComputePipelineBuilder& setShaderStage(VkPipelineShaderStageCreateInfo& stage);
+        ComputePipelineBuilder& setSpecialization(const SpecializationConstants& constants);
         ComputePipelineBuilder& setFlags(VkPipelineCreateFlags flags);
 
         ComputePipelineBuilder& createPipelineLayout(VkPipelineLayout& layout);
@@ -27,11 +49,44 @@ namespace Eos
         bool build(VkPipeline& pipeline, const VkPipelineLayout& layout);
         bool build(VkPipeline& pipeline, VkPipelineLayout& layout, const VkPipelineLayoutCreateInfo& layoutCI);
     private:
+        struct PipelineKey
+        {
+            size_t codeHash;
+            std::shared_ptr<const std::vector<uint32_t>> code;
+            std::string entryPoint;
+            SpecializationConstants specialization;
+            VkPipelineLayout layout;
+            VkPipelineCreateFlags flags;
+
+            bool operator==(const PipelineKey& other) const;
+            size_t hash() const;
+        };
+
+        struct PipelineKeyHash
+        {
+            std::size_t operator()(const PipelineKey& key) const
+            {
+                return key.hash();
+            }
+        };
+
         VkPipelineShaderStageCreateInfo m_ShaderStage;
-        VkPipelineCreateFlags m_Flags;
+        VkPipelineCreateFlags m_Flags = 0;
+
+        SpecializationConstants m_Specialization;
+        bool m_OverrideSpecialization = false;
+
+        // Empty when the stage was set directly, which skips the cache
+        std::shared_ptr<const std::vector<uint32_t>> m_Code;
+        size_t m_CodeHash = 0;
 
         VkDevice* m_Device;
+        PipelineLayoutCache* m_LayoutCache;
 
         static DeletionQueue s_DeletionQueue;
+
+        static std::unordered_map<PipelineKey, VkPipeline, PipelineKeyHash> s_Cache;
+        static Statistics s_Statistics;
+        static std::mutex s_Mutex;
     };
 }
@@ -4,11 +4,13 @@ namespace Eos
 {
     DeletionQueue PipelineBuilder::s_DeletionQueue;
 
-    PipelineBuilder PipelineBuilder::begin(VkDevice* device, VkRenderPass* renderPass)
+    PipelineBuilder PipelineBuilder::begin(VkDevice* device, VkRenderPass* renderPass,
+            PipelineLayoutCache* layoutCache)
     {
         PipelineBuilder builder;
         builder.m_Device = device;
         builder.m_RenderPass = renderPass;
+        builder.m_LayoutCache = layoutCache;
 
         return builder;
     }
@@ -43,6 +45,14 @@ namespace Eos
         return *this;
     }
 
+    PipelineBuilder& PipelineBuilder::setSpecialization(VkShaderStageFlagBits stage,
+            const SpecializationConstants& constants)
+    {
+        m_Specializations[stage] = constants;
+
+        return *this;
+    }
+
     PipelineBuilder& PipelineBuilder::setVertexInputInfo(const VertexInputDescription& description)
     {
         m_VertexDescription = description;
@@ -124,11 +134,24 @@ namespace Eos
     PipelineBuilder& PipelineBuilder::createPipelineLayout(VkPipelineLayout& layout,
             const VkPipelineLayoutCreateInfo& createInfo)
     {
+        if (m_LayoutCache)
+        {
+            layout = m_LayoutCache->createPipelineLayout(&createInfo);
+            return *this;
+        }
+
         if (vkCreatePipelineLayout(*m_Device, &createInfo, nullptr, &layout) != VK_SUCCESS)
         {
             EOS_CORE_LOG_CRITICAL("Failed to create Pipeline Layout");
+            return *this;
         }
 
+        VkDevice tempDevice = *m_Device; // Used for Deletion Queue
+        VkPipelineLayout tempLayout = layout;
+        s_DeletionQueue.pushFunction([=](){
+            vkDestroyPipelineLayout(tempDevice, tempLayout, nullptr);
+        });
+
         return *this;
     }
 
@@ -154,6 +177,13 @@ namespace Eos
         m_VertexInputInfo.vertexBindingDescriptionCount = m_VertexDescription.bindings.size();
         m_VertexInputInfo.pVertexBindingDescriptions = m_VertexDescription.bindings.data();
 
+        for (VkPipelineShaderStageCreateInfo& stage : m_ShaderStages)
+        {
+            auto it = m_Specializations.find(stage.stage);
+            if (it != m_Specializations.end())
+                stage.pSpecializationInfo = it->second.getInfo();
+        }
+
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
         pipelineInfo.pNext = nullptr;
@@ -180,7 +210,6 @@ namespace Eos
 
         VkDevice tempDevice = *m_Device; // Used for Deletion Queue
         s_DeletionQueue.pushFunction([=](){
-            vkDestroyPipelineLayout(tempDevice, layout, nullptr);
             vkDestroyPipeline(tempDevice, pipeline, nullptr);
         });
 
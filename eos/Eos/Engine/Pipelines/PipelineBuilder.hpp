@@ -3,6 +3,8 @@
 #include "Eos/EosPCH.hpp"
 
 #include "Eos/Engine/Pipelines/PipelineCreationInfo.hpp"
+#include "Eos/Engine/Pipelines/PipelineLayoutCache.hpp"
+#include "Eos/Engine/Pipelines/SpecializationConstants.hpp"
 
 #include "Eos/Core/DeletionQueue.hpp"
 
@@ -15,12 +17,16 @@ namespace Eos
     class EOS_API PipelineBuilder
     {
     public:
-        static PipelineBuilder begin(VkDevice* device, VkRenderPass* renderPass);
+        static PipelineBuilder begin(VkDevice* device, VkRenderPass* renderPass,
+                PipelineLayoutCache* layoutCache = nullptr);
         static void cleanup();
 
         PipelineBuilder& defaultValues();
 
         PipelineBuilder& setShaderStages(const std::vector<VkPipelineShaderStageCreateInfo>& stages);
+        // Overrides any constants set on the Shader for that stage
+        PipelineBuilder& setSpecialization(VkShaderStageFlagBits stage,
+                const SpecializationConstants& constants);
         PipelineBuilder& setVertexInputInfo(const VertexInputDescription& description);
         PipelineBuilder& setInputAssembly(const VkPipelineInputAssemblyStateCreateInfo& createInfo);
         PipelineBuilder& setMultisampling(const VkPipelineMultisampleStateCreateInfo& createInfo);
@@ -40,6 +46,7 @@ namespace Eos
         bool build(VkPipeline& pipeline, VkPipelineLayout& layout, const VkPipelineLayoutCreateInfo& createInfo);
     private:
         std::vector<VkPipelineShaderStageCreateInfo> m_ShaderStages;
+        std::unordered_map<VkShaderStageFlagBits, SpecializationConstants> m_Specializations;
         VkPipelineVertexInputStateCreateInfo m_VertexInputInfo{};
         VkPipelineInputAssemblyStateCreateInfo m_InputAssembly{};
         VkPipelineMultisampleStateCreateInfo m_Multisampling{};
@@ -53,6 +60,7 @@ namespace Eos
         std::vector<VkRect2D> m_Scissors;
 
         VkDevice* m_Device;
+        PipelineLayoutCache* m_LayoutCache;
         VkRenderPass* m_RenderPass;
 
         VertexInputDescription m_VertexDescription;
@@ -0,0 +1,98 @@
+#include "PipelineLayoutCache.hpp"
+
+#include "Eos/Core/Hash.hpp"
+
+namespace Eos
+{
+    bool PipelineLayoutCache::PipelineLayoutInfo::operator==(
+            const PipelineLayoutInfo& other) const
+    {
+        if (other.flags != flags || other.setLayouts != setLayouts ||
+                other.pushConstantRanges.size() != pushConstantRanges.size())
+            return false;
+
+        for (size_t i = 0; i < pushConstantRanges.size(); i++)
+        {
+            if (other.pushConstantRanges[i].stageFlags != pushConstantRanges[i].stageFlags)
+                return false;
+
+            if (other.pushConstantRanges[i].offset != pushConstantRanges[i].offset)
+                return false;
+
+            if (other.pushConstantRanges[i].size != pushConstantRanges[i].size)
+                return false;
+        }
+
+        return true;
+    }
+
+    size_t PipelineLayoutCache::PipelineLayoutInfo::hash() const
+    {
+        size_t result = 0;
+        hashCombine(result, flags);
+        hashCombine(result, setLayouts.size());
+
+        for (VkDescriptorSetLayout layout : setLayouts)
+            hashCombine(result, reinterpret_cast<uint64_t>(layout));
+
+        for (const VkPushConstantRange& range : pushConstantRanges)
+        {
+            hashCombine(result, range.stageFlags);
+            hashCombine(result, range.offset);
+            hashCombine(result, range.size);
+        }
+
+        return result;
+    }
+
+    void PipelineLayoutCache::init(VkDevice newDevice)
+    {
+        m_Device = newDevice;
+    }
+
+    void PipelineLayoutCache::cleanup()
+    {
+        for (auto pair : m_LayoutCache)
+        {
+            vkDestroyPipelineLayout(m_Device, pair.second, nullptr);
+        }
+
+        m_LayoutCache.clear();
+    }
+
+    VkPipelineLayout PipelineLayoutCache::createPipelineLayout(
+            const VkPipelineLayoutCreateInfo* info)
+    {
+        PipelineLayoutInfo layoutInfo;
+        layoutInfo.flags = info->flags;
+        layoutInfo.setLayouts.assign(info->pSetLayouts,
+                info->pSetLayouts + info->setLayoutCount);
+        layoutInfo.pushConstantRanges.assign(info->pPushConstantRanges,
+                info->pPushConstantRanges + info->pushConstantRangeCount);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_LayoutCache.find(layoutInfo);
+        if (it != m_LayoutCache.end())
+        {
+            m_Statistics.hits++;
+            return (*it).second;
+        }
+
+        m_Statistics.misses++;
+
+        VkPipelineLayout layout;
+        EOS_VK_CHECK(vkCreatePipelineLayout(m_Device, info, nullptr, &layout));
+
+        m_LayoutCache[layoutInfo] = layout;
+        return layout;
+    }
+
+    PipelineLayoutCache::Statistics PipelineLayoutCache::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Statistics.size = m_LayoutCache.size();
+        return m_Statistics;
+    }
+}
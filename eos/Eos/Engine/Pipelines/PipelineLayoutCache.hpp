@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    class EOS_API PipelineLayoutCache
+    {
+    public:
+        struct PipelineLayoutInfo
+        {
+            std::vector<VkDescriptorSetLayout> setLayouts;
+            std::vector<VkPushConstantRange> pushConstantRanges;
+            VkPipelineLayoutCreateFlags flags = 0;
+
+            bool operator==(const PipelineLayoutInfo& other) const;
+            size_t hash() const;
+        };
+
+        struct Statistics
+        {
+            uint32_t hits = 0;
+            uint32_t misses = 0;
+            size_t size = 0;
+        };
+
+    public:
+        void init(VkDevice newDevice);
+        void cleanup();
+
+        // The cache owns the returned layout, it is destroyed in cleanup
+        VkPipelineLayout createPipelineLayout(const VkPipelineLayoutCreateInfo* info);
+
+        Statistics getStatistics();
+    private:
+        struct PipelineLayoutHash
+        {
+            std::size_t operator()(const PipelineLayoutInfo& info) const
+            {
+                return info.hash();
+            }
+        };
+
+        std::unordered_map<PipelineLayoutInfo, VkPipelineLayout, PipelineLayoutHash>
+            m_LayoutCache;
+        std::mutex m_Mutex;
+
+        Statistics m_Statistics;
+
+        VkDevice m_Device;
+    };
+}
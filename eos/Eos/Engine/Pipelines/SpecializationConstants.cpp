@@ -0,0 +1,79 @@
+#include "SpecializationConstants.hpp"
+
+#include "Eos/Core/Hash.hpp"
+
+namespace Eos
+{
+    void SpecializationConstants::clear()
+    {
+        m_Entries.clear();
+        m_Data.clear();
+    }
+
+    void SpecializationConstants::remove(uint32_t id)
+    {
+        auto it = std::find_if(m_Entries.begin(), m_Entries.end(),
+            [id](const VkSpecializationMapEntry& entry) { return entry.constantID == id; });
+        if (it == m_Entries.end())
+            return;
+
+        uint32_t offset = it->offset;
+        size_t size = it->size;
+        m_Entries.erase(it);
+
+        // Entries added with set are packed, so later ones move down
+        m_Data.erase(m_Data.begin() + offset, m_Data.begin() + offset + size);
+        for (VkSpecializationMapEntry& entry : m_Entries)
+        {
+            if (entry.offset > offset)
+                entry.offset -= static_cast<uint32_t>(size);
+        }
+    }
+
+    const VkSpecializationInfo* SpecializationConstants::getInfo()
+    {
+        if (m_Entries.empty())
+            return nullptr;
+
+        m_Info.mapEntryCount = static_cast<uint32_t>(m_Entries.size());
+        m_Info.pMapEntries = m_Entries.data();
+        m_Info.dataSize = m_Data.size();
+        m_Info.pData = m_Data.data();
+
+        return &m_Info;
+    }
+
+    bool SpecializationConstants::operator==(const SpecializationConstants& other) const
+    {
+        if (other.m_Data != m_Data || other.m_Entries.size() != m_Entries.size())
+            return false;
+
+        for (size_t i = 0; i < m_Entries.size(); i++)
+        {
+            if (other.m_Entries[i].constantID != m_Entries[i].constantID ||
+                    other.m_Entries[i].offset != m_Entries[i].offset ||
+                    other.m_Entries[i].size != m_Entries[i].size)
+                return false;
+        }
+
+        return true;
+    }
+
+    size_t SpecializationConstants::hash() const
+    {
+        size_t result = 0;
+        hashCombine(result, m_Entries.size());
+
+        for (const VkSpecializationMapEntry& entry : m_Entries)
+        {
+            hashCombine(result, entry.constantID);
+            hashCombine(result, entry.offset);
+            hashCombine(result, entry.size);
+        }
+
+        for (uint8_t byte : m_Data)
+            hashCombine(result, byte);
+
+        return result;
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include <vulkan/vulkan.h>
+
+// Maps a member of a struct to a constant_id, for use with
+// SpecializationConstants::fromStruct
+#define EOS_SPECIALIZATION_ENTRY(id, type, member) \
+    VkSpecializationMapEntry{ id, static_cast<uint32_t>(offsetof(type, member)), \
+        sizeof(type::member) }
+
+namespace Eos
+{
+    // Values for `layout (constant_id = N)` declarations, applied when the
+    // pipeline is created. The data is owned here, so getInfo() stays valid
+    // for as long as this object is not modified or moved
+    class EOS_API SpecializationConstants
+    {
+    public:
+        template <typename T>
+        SpecializationConstants& set(uint32_t id, const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>,
+                    "Specialization constants have to be plain values");
+
+            // Booleans are 32 bit in SPIR-V
+            if constexpr (std::is_same_v<T, bool>)
+                return set<VkBool32>(id, value ? VK_TRUE : VK_FALSE);
+
+            for (VkSpecializationMapEntry& entry : m_Entries)
+            {
+                if (entry.constantID != id)
+                    continue;
+
+                if (entry.size == sizeof(T))
+                {
+                    std::memcpy(m_Data.data() + entry.offset, &value, sizeof(T));
+                    return *this;
+                }
+
+                // Set again with another type, the old value is replaced
+                remove(id);
+                break;
+            }
+
+            VkSpecializationMapEntry entry;
+            entry.constantID = id;
+            entry.offset = static_cast<uint32_t>(m_Data.size());
+            entry.size = sizeof(T);
+
+            m_Data.resize(m_Data.size() + sizeof(T));
+            std::memcpy(m_Data.data() + entry.offset, &value, sizeof(T));
+
+            m_Entries.push_back(entry);
+            return *this;
+        }
+
+        // Entries are usually built with EOS_SPECIALIZATION_ENTRY
+        template <typename T>
+        static SpecializationConstants fromStruct(const T& data,
+                std::initializer_list<VkSpecializationMapEntry> entries)
+        {
+            static_assert(std::is_trivially_copyable_v<T>,
+                    "Specialization data has to be trivially copyable");
+
+            // Only the listed members are copied, padding stays zero so it
+            // can not change the hash
+            SpecializationConstants constants;
+            constants.m_Data.assign(sizeof(T), 0);
+            constants.m_Entries.assign(entries);
+
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&data);
+            for (const VkSpecializationMapEntry& entry : constants.m_Entries)
+            {
+                if (entry.offset + entry.size > sizeof(T))
+                {
+                    EOS_CORE_LOG_ERROR("Specialization constant {} is outside of the struct",
+                            entry.constantID);
+                    continue;
+                }
+
+                std::memcpy(constants.m_Data.data() + entry.offset, bytes + entry.offset,
+                        entry.size);
+            }
+
+            return constants;
+        }
+
+        bool empty() const { return m_Entries.empty(); }
+        void clear();
+
+        // Removes the constant and its data, nothing happens if it was not set
+        void remove(uint32_t id);
+
+        // nullptr when there are no constants
+        const VkSpecializationInfo* getInfo();
+
+        bool operator==(const SpecializationConstants& other) const;
+        size_t hash() const;
+    private:
+        std::vector<VkSpecializationMapEntry> m_Entries;
+        std::vector<uint8_t> m_Data;
+
+        VkSpecializationInfo m_Info{};
+    };
+}
@@ -0,0 +1,238 @@
+#include "ReadbackRing.hpp"
+
+#include "Eos/Engine/BarrierBatcher.hpp"
+#include "Eos/Engine/GlobalData.hpp"
+
+namespace Eos
+{
+    // Covers the texel sizes of every supported format
+    static constexpr VkDeviceSize s_Alignment = 16;
+
+    void ReadbackRing::init(uint32_t framesInFlight, VkDeviceSize capacity)
+    {
+        m_FramesInFlight = framesInFlight;
+        m_Capacity = capacity;
+
+        // Random access host memory is cached, unlike the sequential write
+        // memory used for uploads, so reading it back is fast
+        m_Buffer.create(capacity, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_AUTO,
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(GlobalData::getAllocator(), m_Buffer.allocation, &allocationInfo);
+        m_Mapped = static_cast<uint8_t*>(allocationInfo.pMappedData);
+
+        m_Statistics.capacity = capacity;
+    }
+
+    void ReadbackRing::cleanup()
+    {
+        // Only called once the device is idle, so every copy has finished
+        while (!m_Requests.empty())
+        {
+            complete(m_Requests.front());
+            m_Requests.pop_front();
+        }
+
+        m_Buffer.destroy();
+        m_Mapped = nullptr;
+    }
+
+    bool ReadbackRing::readBuffer(VkCommandBuffer cmd, const Buffer& source, VkDeviceSize offset,
+            VkDeviceSize size, Callback&& callback, VkPipelineStageFlags2 srcStage,
+            VkAccessFlags2 srcAccess)
+    {
+        VkDeviceSize ringOffset;
+        if (!allocate(size, ringOffset))
+            return false;
+
+        BarrierBatcher barriers;
+        barriers.bufferBarrier(source, srcStage, srcAccess, VK_PIPELINE_STAGE_2_COPY_BIT,
+                VK_ACCESS_2_TRANSFER_READ_BIT, offset, size)
+            .flush(cmd);
+
+        VkBufferCopy copy{};
+        copy.srcOffset = offset;
+        copy.dstOffset = ringOffset;
+        copy.size = size;
+
+        vkCmdCopyBuffer(cmd, source.buffer, m_Buffer.buffer, 1, &copy);
+
+        barriers.bufferBarrier(m_Buffer, VK_PIPELINE_STAGE_2_COPY_BIT,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_HOST_BIT,
+                VK_ACCESS_2_HOST_READ_BIT, ringOffset, size)
+            .flush(cmd);
+
+        m_Requests.push_back({ ringOffset, size, m_Frame, std::move(callback) });
+        return true;
+    }
+
+    bool ReadbackRing::readImage(VkCommandBuffer cmd, Texture2D& source, Callback&& callback,
+            uint32_t mipLevel, uint32_t arrayLayer)
+    {
+        uint32_t texelSize = Texture2D::getTexelSize(source.format);
+        if (texelSize == 0)
+        {
+            EOS_CORE_LOG_ERROR("Texture format {} can not be read back", source.format);
+            return false;
+        }
+
+        uint32_t width = std::max(source.extent.width >> mipLevel, 1u);
+        uint32_t height = std::max(source.extent.height >> mipLevel, 1u);
+        VkDeviceSize size = static_cast<VkDeviceSize>(width) * height * texelSize;
+
+        VkDeviceSize ringOffset;
+        if (!allocate(size, ringOffset))
+            return false;
+
+        BarrierBatcher barriers;
+        barriers.transition(source, Access::TransferSrc, mipLevel, 1, arrayLayer, 1)
+            .flush(cmd);
+
+        VkBufferImageCopy copy{};
+        copy.bufferOffset = ringOffset;
+        copy.bufferRowLength = 0;
+        copy.bufferImageHeight = 0;
+        copy.imageSubresource.aspectMask = source.aspectFlags;
+        copy.imageSubresource.mipLevel = mipLevel;
+        copy.imageSubresource.baseArrayLayer = arrayLayer;
+        copy.imageSubresource.layerCount = 1;
+        copy.imageOffset = { 0, 0, 0 };
+        copy.imageExtent = { width, height, 1 };
+
+        vkCmdCopyImageToBuffer(cmd, source.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                m_Buffer.buffer, 1, &copy);
+
+        barriers.bufferBarrier(m_Buffer, VK_PIPELINE_STAGE_2_COPY_BIT,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_HOST_BIT,
+                VK_ACCESS_2_HOST_READ_BIT, ringOffset, size)
+            .flush(cmd);
+
+        m_Requests.push_back({ ringOffset, size, m_Frame, std::move(callback) });
+        return true;
+    }
+
+    std::future<std::vector<uint8_t>> ReadbackRing::readBuffer(VkCommandBuffer cmd,
+            const Buffer& source, VkDeviceSize offset, VkDeviceSize size)
+    {
+        std::shared_ptr<std::promise<std::vector<uint8_t>>> promise =
+            std::make_shared<std::promise<std::vector<uint8_t>>>();
+        std::future<std::vector<uint8_t>> future = promise->get_future();
+
+        bool recorded = readBuffer(cmd, source, offset, size,
+                [promise](const void* data, VkDeviceSize size) {
+                    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                    promise->set_value(std::vector<uint8_t>(bytes, bytes + size));
+                });
+
+        if (!recorded)
+            promise->set_value({});
+
+        return future;
+    }
+
+    std::future<std::vector<uint8_t>> ReadbackRing::readImage(VkCommandBuffer cmd,
+            Texture2D& source, uint32_t mipLevel, uint32_t arrayLayer)
+    {
+        std::shared_ptr<std::promise<std::vector<uint8_t>>> promise =
+            std::make_shared<std::promise<std::vector<uint8_t>>>();
+        std::future<std::vector<uint8_t>> future = promise->get_future();
+
+        bool recorded = readImage(cmd, source,
+                [promise](const void* data, VkDeviceSize size) {
+                    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                    promise->set_value(std::vector<uint8_t>(bytes, bytes + size));
+                }, mipLevel, arrayLayer);
+
+        if (!recorded)
+            promise->set_value({});
+
+        return future;
+    }
+
+    void ReadbackRing::update(uint64_t frame)
+    {
+        m_Frame = frame;
+
+        // The fence of a frame has been waited on framesInFlight frames later
+        while (!m_Requests.empty() && m_Requests.front().frame + m_FramesInFlight <= m_Frame)
+        {
+            complete(m_Requests.front());
+            m_Requests.pop_front();
+        }
+
+        if (m_Requests.empty())
+            m_Head = 0;
+    }
+
+    ReadbackRing::Statistics ReadbackRing::getStatistics() const
+    {
+        Statistics statistics = m_Statistics;
+        statistics.pending = static_cast<uint32_t>(m_Requests.size());
+
+        for (const Request& request : m_Requests)
+            statistics.used += request.size;
+
+        return statistics;
+    }
+
+    bool ReadbackRing::allocate(VkDeviceSize size, VkDeviceSize& offset)
+    {
+        VkDeviceSize alignedSize = (size + s_Alignment - 1) & ~(s_Alignment - 1);
+
+        bool fits = false;
+        if (m_Requests.empty())
+        {
+            offset = 0;
+            fits = alignedSize <= m_Capacity;
+        }
+        else
+        {
+            VkDeviceSize tail = m_Requests.front().offset;
+
+            if (tail < m_Head)
+            {
+                // Free space is after the head and before the tail, wrapping
+                // to the start when the end is too small
+                if (m_Head + alignedSize <= m_Capacity)
+                {
+                    offset = m_Head;
+                    fits = true;
+                }
+                else if (alignedSize <= tail)
+                {
+                    offset = 0;
+                    fits = true;
+                }
+            }
+            else if (m_Head + alignedSize <= tail)
+            {
+                offset = m_Head;
+                fits = true;
+            }
+        }
+
+        if (!fits)
+        {
+            // Dropping keeps the frame from ever waiting on a readback
+            m_Statistics.dropped++;
+            EOS_CORE_LOG_WARN("Readback ring is full, dropped a {} byte readback", size);
+            return false;
+        }
+
+        m_Head = offset + alignedSize;
+        return true;
+    }
+
+    void ReadbackRing::complete(Request& request)
+    {
+        // The memory may not be host coherent
+        vmaInvalidateAllocation(GlobalData::getAllocator(), m_Buffer.allocation,
+                request.offset, request.size);
+
+        if (request.callback)
+            request.callback(m_Mapped + request.offset, request.size);
+
+        m_Statistics.completed++;
+    }
+}
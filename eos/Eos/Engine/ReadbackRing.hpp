@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/Texture.hpp"
+
+#include <deque>
+#include <future>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Copies GPU data into host cached memory without waiting on the GPU.
+    // Copies are recorded into the frame's command buffer and the results
+    // are handed back once that frame's fence has been waited on, which is
+    // framesInFlight frames later
+    class EOS_API ReadbackRing
+    {
+    public:
+        using Callback = std::function<void(const void* data, VkDeviceSize size)>;
+
+        struct Statistics
+        {
+            VkDeviceSize capacity = 0;
+            VkDeviceSize used = 0;
+            uint32_t pending = 0;
+            uint32_t completed = 0;
+            uint32_t dropped = 0;
+        };
+
+    public:
+        void init(uint32_t framesInFlight, VkDeviceSize capacity = 16 * 1024 * 1024);
+        void cleanup();
+
+        // cmd has to be the command buffer of the current frame. The source
+        // stage and access are what last wrote to the buffer. Returns false,
+        // and never calls callback, when the ring is full
+        bool readBuffer(VkCommandBuffer cmd, const Buffer& source, VkDeviceSize offset,
+                VkDeviceSize size, Callback&& callback,
+                VkPipelineStageFlags2 srcStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                VkAccessFlags2 srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT);
+
+        // Reads one mip level of one layer, tightly packed. The texture is
+        // left in TRANSFER_SRC_OPTIMAL
+        bool readImage(VkCommandBuffer cmd, Texture2D& source, Callback&& callback,
+                uint32_t mipLevel = 0, uint32_t arrayLayer = 0);
+
+        // The future holds no data when the ring was full
+        std::future<std::vector<uint8_t>> readBuffer(VkCommandBuffer cmd, const Buffer& source,
+                VkDeviceSize offset, VkDeviceSize size);
+        std::future<std::vector<uint8_t>> readImage(VkCommandBuffer cmd, Texture2D& source,
+                uint32_t mipLevel = 0, uint32_t arrayLayer = 0);
+
+        // Runs the callbacks of every frame the GPU has finished
+        void update(uint64_t frame);
+
+        Statistics getStatistics() const;
+    private:
+        struct Request
+        {
+            VkDeviceSize offset;
+            VkDeviceSize size;
+            uint64_t frame;
+            Callback callback;
+        };
+
+        Buffer m_Buffer;
+        uint8_t* m_Mapped = nullptr;
+
+        VkDeviceSize m_Capacity = 0;
+        VkDeviceSize m_Head = 0;
+
+        // Oldest first, so the front marks the tail of the ring
+        std::deque<Request> m_Requests;
+
+        uint32_t m_FramesInFlight = 0;
+        uint64_t m_Frame = 0;
+
+        Statistics m_Statistics;
+    private:
+        bool allocate(VkDeviceSize size, VkDeviceSize& offset);
+        void complete(Request& request);
+    };
+}
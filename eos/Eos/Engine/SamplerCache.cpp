@@ -0,0 +1,117 @@
+#include "SamplerCache.hpp"
+
+#include "Eos/Core/Hash.hpp"
+
+namespace Eos
+{
+    bool SamplerCache::SamplerInfo::operator==(const SamplerInfo& other) const
+    {
+        const VkSamplerCreateInfo& a = info;
+        const VkSamplerCreateInfo& b = other.info;
+
+        return a.flags == b.flags &&
+            a.magFilter == b.magFilter &&
+            a.minFilter == b.minFilter &&
+            a.mipmapMode == b.mipmapMode &&
+            a.addressModeU == b.addressModeU &&
+            a.addressModeV == b.addressModeV &&
+            a.addressModeW == b.addressModeW &&
+            a.mipLodBias == b.mipLodBias &&
+            a.anisotropyEnable == b.anisotropyEnable &&
+            a.maxAnisotropy == b.maxAnisotropy &&
+            a.compareEnable == b.compareEnable &&
+            a.compareOp == b.compareOp &&
+            a.minLod == b.minLod &&
+            a.maxLod == b.maxLod &&
+            a.borderColor == b.borderColor &&
+            a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+    }
+
+    size_t SamplerCache::SamplerInfo::hash() const
+    {
+        size_t result = 0;
+        hashCombine(result, info.flags);
+        hashCombine(result, info.magFilter);
+        hashCombine(result, info.minFilter);
+        hashCombine(result, info.mipmapMode);
+        hashCombine(result, info.addressModeU);
+        hashCombine(result, info.addressModeV);
+        hashCombine(result, info.addressModeW);
+        hashCombine(result, info.mipLodBias);
+        hashCombine(result, info.anisotropyEnable);
+        hashCombine(result, info.maxAnisotropy);
+        hashCombine(result, info.compareEnable);
+        hashCombine(result, info.compareOp);
+        hashCombine(result, info.minLod);
+        hashCombine(result, info.maxLod);
+        hashCombine(result, info.borderColor);
+        hashCombine(result, info.unnormalizedCoordinates);
+
+        return result;
+    }
+
+    void SamplerCache::init(VkDevice newDevice)
+    {
+        m_Device = newDevice;
+    }
+
+    void SamplerCache::cleanup()
+    {
+        for (auto pair : m_SamplerCache)
+        {
+            vkDestroySampler(m_Device, pair.second, nullptr);
+        }
+
+        for (VkSampler sampler : m_UncachedSamplers)
+        {
+            vkDestroySampler(m_Device, sampler, nullptr);
+        }
+
+        m_SamplerCache.clear();
+        m_UncachedSamplers.clear();
+    }
+
+    VkSampler SamplerCache::createSampler(const VkSamplerCreateInfo* info)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // Extension structs can not be compared safely, so these always get
+        // their own sampler
+        if (info->pNext != nullptr)
+        {
+            m_Statistics.misses++;
+
+            VkSampler sampler;
+            EOS_VK_CHECK(vkCreateSampler(m_Device, info, nullptr, &sampler));
+
+            m_UncachedSamplers.push_back(sampler);
+            return sampler;
+        }
+
+        SamplerInfo samplerInfo;
+        samplerInfo.info = *info;
+
+        auto it = m_SamplerCache.find(samplerInfo);
+        if (it != m_SamplerCache.end())
+        {
+            m_Statistics.hits++;
+            return (*it).second;
+        }
+
+        m_Statistics.misses++;
+
+        VkSampler sampler;
+        EOS_VK_CHECK(vkCreateSampler(m_Device, info, nullptr, &sampler));
+
+        m_SamplerCache[samplerInfo] = sampler;
+        return sampler;
+    }
+
+    SamplerCache::Statistics SamplerCache::getStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Statistics.size = m_SamplerCache.size() + m_UncachedSamplers.size();
+        return m_Statistics;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Shares samplers between every user asking for the same state. Create
+    // infos with a pNext chain are not cached
+    class EOS_API SamplerCache
+    {
+    public:
+        struct SamplerInfo
+        {
+            VkSamplerCreateInfo info;
+
+            bool operator==(const SamplerInfo& other) const;
+            size_t hash() const;
+        };
+
+        struct Statistics
+        {
+            uint32_t hits = 0;
+            uint32_t misses = 0;
+            size_t size = 0;
+        };
+
+    public:
+        void init(VkDevice newDevice);
+        void cleanup();
+
+        // The cache owns the returned sampler, it is destroyed in cleanup
+        VkSampler createSampler(const VkSamplerCreateInfo* info);
+
+        Statistics getStatistics();
+    private:
+        struct SamplerHash
+        {
+            std::size_t operator()(const SamplerInfo& info) const
+            {
+                return info.hash();
+            }
+        };
+
+        std::unordered_map<SamplerInfo, VkSampler, SamplerHash> m_SamplerCache;
+        std::vector<VkSampler> m_UncachedSamplers;
+        std::mutex m_Mutex;
+
+        Statistics m_Statistics;
+
+        VkDevice m_Device;
+    };
+}
@@ -53,6 +53,25 @@ namespace Eos
     {
         m_DeletionQueue.flush();
         m_ShaderStages.clear();
+        m_Specializations.clear();
+    }
+
+    void Shader::setSpecialization(VkShaderStageFlagBits stage,
+            const SpecializationConstants& constants)
+    {
+        for (VkPipelineShaderStageCreateInfo& info : m_ShaderStages)
+        {
+            if (info.stage != stage)
+                continue;
+
+            SpecializationConstants& stored = m_Specializations[stage];
+            stored = constants;
+
+            info.pSpecializationInfo = stored.getInfo();
+            return;
+        }
+
+        EOS_CORE_LOG_ERROR("No shader module for the specialized stage");
     }
 
     std::vector<VkPipelineShaderStageCreateInfo>& Shader::getShaderStages()
@@ -2,6 +2,7 @@
 
 #include "Eos/EosPCH.hpp"
 #include "Eos/Core/DeletionQueue.hpp"
+#include "Eos/Engine/Pipelines/SpecializationConstants.hpp"
 
 #include <vulkan/vulkan.h>
 
@@ -16,9 +17,15 @@ namespace Eos
         void addShaderModule(VkShaderStageFlagBits stage, const char* path);
         void clearModules();
 
+        // Applies to the module already added for stage
+        void setSpecialization(VkShaderStageFlagBits stage,
+                const SpecializationConstants& constants);
+
         std::vector<VkPipelineShaderStageCreateInfo>& getShaderStages();
     private:
         std::vector<VkPipelineShaderStageCreateInfo> m_ShaderStages;
+        // Node based, so the pointers held by the stages stay valid
+        std::unordered_map<VkShaderStageFlagBits, SpecializationConstants> m_Specializations;
         DeletionQueue m_DeletionQueue;
     private:
         void addShaderStage(VkShaderStageFlagBits stage, VkShaderModule& shaderModule);
@@ -12,8 +12,12 @@ namespace Eos
         static void setup(Queue* queue);
         
         static void submit(std::function<void(VkCommandBuffer)>&& function);
+
+        // Returns without waiting for the GPU. Barriers recorded later on the
+        // same queue synchronise with it, and the resources it uses have to
+        // stay alive until it has finished
+        static void submitAsync(std::function<void(VkCommandBuffer)>&& function);
     private:
-        static UploadContext s_UploadContext;
         static Queue* s_GraphicsQueue;
     private:
         GraphicsSubmit() {}
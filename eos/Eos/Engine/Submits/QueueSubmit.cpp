@@ -0,0 +1,44 @@
+#include "QueueSubmit.hpp"
+
+#include "Eos/Engine/Initializers.hpp"
+#include "Eos/Engine/GlobalData.hpp"
+
+namespace Eos
+{
+    void QueueSubmit::submit(Queue* queue, std::function<void(VkCommandBuffer)>&& function,
+            bool wait)
+    {
+        CommandPools& commandPools = GlobalData::getCommandPools();
+        FencePool& fencePool = GlobalData::getFencePool();
+
+        VkCommandBuffer cmd = commandPools.acquire(queue->family);
+        VkFence fence = fencePool.acquire();
+
+        VkCommandBufferBeginInfo cmdBeginInfo = Init::commandBufferBeginInfo(
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+        EOS_VK_CHECK(vkBeginCommandBuffer(cmd, &cmdBeginInfo));
+
+        function(cmd);
+
+        EOS_VK_CHECK(vkEndCommandBuffer(cmd));
+
+        VkSubmitInfo submit = Init::submitInfo(&cmd);
+
+        EOS_VK_CHECK(queue->submit(1, &submit, fence));
+
+        if (wait)
+        {
+            EOS_VK_CHECK(vkWaitForFences(GlobalData::getDevice(), 1, &fence, true,
+                        9999999999));
+
+            commandPools.release(cmd, queue->family);
+        }
+        else
+        {
+            commandPools.release(cmd, queue->family, fence);
+        }
+
+        fencePool.release(fence);
+    }
+}
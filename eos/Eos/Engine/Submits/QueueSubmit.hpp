@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Records function into a pooled command buffer and submits it to queue
+    // with a pooled fence. Shared by GraphicsSubmit and TransferSubmit
+    class EOS_API QueueSubmit
+    {
+    public:
+        // When wait is false the command buffer and fence are handed back to
+        // their pools, which reuse them once the fence has signalled
+        static void submit(Queue* queue, std::function<void(VkCommandBuffer)>&& function,
+                bool wait);
+    private:
+        QueueSubmit() {}
+        ~QueueSubmit() {}
+    };
+}
@@ -0,0 +1,143 @@
+#include "SyncPools.hpp"
+
+#include "Eos/Engine/Initializers.hpp"
+
+namespace Eos
+{
+    void FencePool::init(VkDevice device)
+    {
+        m_Device = device;
+    }
+
+    void FencePool::cleanup()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (VkFence fence : m_Free)
+            vkDestroyFence(m_Device, fence, nullptr);
+        for (VkFence fence : m_Pending)
+            vkDestroyFence(m_Device, fence, nullptr);
+
+        m_Free.clear();
+        m_Pending.clear();
+    }
+
+    VkFence FencePool::acquire()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Free.empty())
+            recycle();
+
+        if (!m_Free.empty())
+        {
+            VkFence fence = m_Free.back();
+            m_Free.pop_back();
+
+            return fence;
+        }
+
+        VkFence fence;
+        VkFenceCreateInfo fenceCI = Init::fenceCreateInfo();
+        EOS_VK_CHECK(vkCreateFence(m_Device, &fenceCI, nullptr, &fence));
+
+        m_Created++;
+        return fence;
+    }
+
+    void FencePool::release(VkFence fence, bool submitted)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (submitted)
+            m_Pending.push_back(fence);
+        else
+            m_Free.push_back(fence);
+    }
+
+    void FencePool::recycle()
+    {
+        for (size_t i = 0; i < m_Pending.size();)
+        {
+            if (vkGetFenceStatus(m_Device, m_Pending[i]) != VK_SUCCESS)
+            {
+                i++;
+                continue;
+            }
+
+            EOS_VK_CHECK(vkResetFences(m_Device, 1, &m_Pending[i]));
+            m_Free.push_back(m_Pending[i]);
+
+            m_Pending[i] = m_Pending.back();
+            m_Pending.pop_back();
+        }
+    }
+
+    void SemaphorePool::init(VkDevice device)
+    {
+        m_Device = device;
+    }
+
+    void SemaphorePool::cleanup()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (VkSemaphore semaphore : m_Free)
+            vkDestroySemaphore(m_Device, semaphore, nullptr);
+        for (const PendingSemaphore& pending : m_Pending)
+            vkDestroySemaphore(m_Device, pending.semaphore, nullptr);
+
+        m_Free.clear();
+        m_Pending.clear();
+    }
+
+    VkSemaphore SemaphorePool::acquire()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Free.empty())
+            recycle();
+
+        if (!m_Free.empty())
+        {
+            VkSemaphore semaphore = m_Free.back();
+            m_Free.pop_back();
+
+            return semaphore;
+        }
+
+        VkSemaphore semaphore;
+        VkSemaphoreCreateInfo semaphoreCI = Init::semaphoreCreateInfo();
+        EOS_VK_CHECK(vkCreateSemaphore(m_Device, &semaphoreCI, nullptr, &semaphore));
+
+        m_Created++;
+        return semaphore;
+    }
+
+    void SemaphorePool::release(VkSemaphore semaphore, VkFence completion)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (completion == VK_NULL_HANDLE)
+            m_Free.push_back(semaphore);
+        else
+            m_Pending.push_back({ semaphore, completion });
+    }
+
+    void SemaphorePool::recycle()
+    {
+        for (size_t i = 0; i < m_Pending.size();)
+        {
+            if (vkGetFenceStatus(m_Device, m_Pending[i].completion) != VK_SUCCESS)
+            {
+                i++;
+                continue;
+            }
+
+            m_Free.push_back(m_Pending[i].semaphore);
+
+            m_Pending[i] = m_Pending.back();
+            m_Pending.pop_back();
+        }
+    }
+}
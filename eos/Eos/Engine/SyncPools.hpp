@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    // Unsignalled fences that are reused rather than created per submission
+    class EOS_API FencePool
+    {
+    public:
+        void init(VkDevice device);
+        void cleanup();
+
+        VkFence acquire();
+
+        // The fence is reset and reused once it has signalled. Fences that
+        // were never submitted can be released straight away
+        void release(VkFence fence, bool submitted = true);
+
+        uint32_t getCreatedCount() const { return m_Created; }
+    private:
+        std::vector<VkFence> m_Free;
+        std::vector<VkFence> m_Pending;
+
+        uint32_t m_Created = 0;
+
+        std::mutex m_Mutex;
+
+        VkDevice m_Device;
+    private:
+        void recycle();
+    };
+
+    // Binary semaphores, reused once the work waiting on them has finished
+    class EOS_API SemaphorePool
+    {
+    public:
+        void init(VkDevice device);
+        void cleanup();
+
+        VkSemaphore acquire();
+
+        // completion has to signal after the wait on the semaphore has
+        // executed, usually the fence of the submission waiting on it
+        void release(VkSemaphore semaphore, VkFence completion = VK_NULL_HANDLE);
+
+        uint32_t getCreatedCount() const { return m_Created; }
+    private:
+        struct PendingSemaphore
+        {
+            VkSemaphore semaphore;
+            VkFence completion;
+        };
+
+        std::vector<VkSemaphore> m_Free;
+        std::vector<PendingSemaphore> m_Pending;
+
+        uint32_t m_Created = 0;
+
+        std::mutex m_Mutex;
+
+        VkDevice m_Device;
+    private:
+        void recycle();
+    };
+}
@@ -1,14 +1,35 @@
 #include "Texture.hpp"
 
+#include "Eos/Engine/Defragmenter.hpp"
 #include "Eos/Engine/GlobalData.hpp"
 
 #include "Eos/Engine/Submits/GraphicsSubmit.hpp"
+#include "Eos/Engine/TextureLoader.hpp"
+
+#include <algorithm>
 #include <vulkan/vulkan_core.h>
 
 namespace Eos
 {
-    void Texture2D::loadFromFile(const char* file)
+    void Texture2D::loadFromFile(const char* file, bool generateMips)
+    {
+        Buffer stagingBuffer;
+        std::vector<VkBufferImageCopy> regions;
+
+        if (!prepareFromFile(file, generateMips, stagingBuffer, regions))
+            return;
+
+        transferBufferToImage(stagingBuffer, regions);
+
+        stagingBuffer.destroy();
+    }
+
+    bool Texture2D::prepareFromFile(const char* file, bool generateMips, Buffer& stagingBuffer,
+            std::vector<VkBufferImageCopy>& regions)
     {
+        if (TextureLoader::isContainerFile(file))
+            return prepareFromContainer(file, generateMips, stagingBuffer, regions);
+
         int texWidth;
         int texHeight;
         int texChannels;
@@ -18,22 +39,26 @@ namespace Eos
         if (!pixels)
         {
             EOS_CORE_LOG_ERROR("Failed to load Texture {}", file);
-            return;
+            return false;
         }
 
         format = VK_FORMAT_R8G8B8A8_SRGB;
         extent.width = texWidth;
         extent.height = texHeight;
         extent.depth = 1;
+        mipLevels = generateMips && supportsMipGeneration(format) ? calculateMipLevels(extent) : 1;
+
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        if (mipLevels > 1)
+            usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
-        createImage(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                VMA_MEMORY_USAGE_GPU_ONLY);
+        createImage(usage, VMA_MEMORY_USAGE_GPU_ONLY);
         createImageView(VK_IMAGE_ASPECT_COLOR_BIT);
         createSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
 
-        size_t totalSize = texWidth * texHeight * texChannels;
+        // Pixels are always loaded as RGBA
+        size_t totalSize = static_cast<size_t>(texWidth) * texHeight * 4;
 
-        Buffer stagingBuffer;
         stagingBuffer.create(totalSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                 VMA_MEMORY_USAGE_CPU_ONLY);
 
@@ -44,17 +69,97 @@ namespace Eos
             memcpy(data, pixelsPtr, totalSize);
         vmaUnmapMemory(GlobalData::getAllocator(), stagingBuffer.allocation);
 
-        transferBufferToImage(stagingBuffer);
+        stbi_image_free(pixels);
+
+        VkBufferImageCopy copyRegion{};
+        copyRegion.bufferOffset = 0;
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.mipLevel = 0;
+        copyRegion.imageSubresource.baseArrayLayer = 0;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageExtent = extent;
+
+        regions = { copyRegion };
+        return true;
+    }
+
+    bool Texture2D::prepareFromContainer(const char* file, bool generateMips,
+            Buffer& stagingBuffer, std::vector<VkBufferImageCopy>& regions)
+    {
+        TextureData textureData;
+        if (!TextureLoader::load(file, textureData))
+            return false;
+
+        if (!TextureLoader::isFormatSupported(textureData.format))
+        {
+            if (!TextureLoader::decodeToRGBA(textureData))
+            {
+                EOS_CORE_LOG_ERROR("Texture {} uses a format not supported by this device", file);
+                return false;
+            }
+
+            EOS_CORE_LOG_WARN("Texture {} was decoded on the CPU", file);
+        }
+
+        format = textureData.format;
+        extent = textureData.extent;
+        mipLevels = textureData.levels.size();
+
+        // Compressed formats can not be blitted, so only uncompressed files
+        // without a mip chain have one generated
+        bool generate = generateMips && mipLevels == 1 &&
+            !TextureLoader::isCompressedFormat(format) && supportsMipGeneration(format);
+        if (generate)
+            mipLevels = calculateMipLevels(extent);
+
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        if (generate)
+            usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+        createImage(usage, VMA_MEMORY_USAGE_GPU_ONLY);
+        createImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+        createSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+
+        stagingBuffer.create(textureData.data.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VMA_MEMORY_USAGE_CPU_ONLY);
+
+        void* data;
+        vmaMapMemory(GlobalData::getAllocator(), stagingBuffer.allocation, &data);
+            memcpy(data, textureData.data.data(), textureData.data.size());
+        vmaUnmapMemory(GlobalData::getAllocator(), stagingBuffer.allocation);
+
+        regions.clear();
+        for (uint32_t i = 0; i < textureData.levels.size(); i++)
+        {
+            const TextureLevel& level = textureData.levels[i];
 
-        vmaDestroyBuffer(Eos::GlobalData::getAllocator(), stagingBuffer.buffer,
-                stagingBuffer.allocation);
+            VkBufferImageCopy copyRegion{};
+            copyRegion.bufferOffset = level.offset;
+            copyRegion.bufferRowLength = 0;
+            copyRegion.bufferImageHeight = 0;
+            copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.imageSubresource.mipLevel = i;
+            copyRegion.imageSubresource.baseArrayLayer = 0;
+            copyRegion.imageSubresource.layerCount = 1;
+            copyRegion.imageExtent = { level.width, level.height, 1 };
+
+            regions.push_back(copyRegion);
+        }
+
+        return true;
     }
 
     void Texture2D::createImage(VkFormat format, VkImageUsageFlags usageFlags, VkExtent3D extent,
-            VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags memoryFlags)
+            VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags memoryFlags, uint32_t mipLevels,
+            uint32_t arrayLayers)
     {
         this->extent = extent;
         this->format = format;
+        this->mipLevels = mipLevels;
+        this->arrayLayers = arrayLayers;
+        this->viewType = arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
 
         createImage(usageFlags, memoryUsage, memoryFlags);
     }
@@ -66,23 +171,27 @@ namespace Eos
 
     void Texture2D::createImageView(VkFormat format, VkImageAspectFlags flags)
     {
+        viewFormat = format;
+        aspectFlags = flags;
+
         VkImageViewCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         info.pNext = nullptr;
-        info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        info.viewType = viewType;
         info.image = image;
         info.format = format;
         info.subresourceRange.baseMipLevel = 0;
-        info.subresourceRange.levelCount = 1;
+        info.subresourceRange.levelCount = mipLevels;
         info.subresourceRange.baseArrayLayer = 0;
-        info.subresourceRange.layerCount = 1;
+        info.subresourceRange.layerCount = arrayLayers;
         info.subresourceRange.aspectMask = flags;
 
         EOS_VK_CHECK(vkCreateImageView(GlobalData::getDevice(),
                     &info, nullptr, &imageView));
     }
 
-    void Texture2D::createSampler(VkFilter filter, VkSamplerAddressMode addressMode)
+    void Texture2D::createSampler(VkFilter filter, VkSamplerAddressMode addressMode,
+            bool enableAnisotropy)
     {
         VkSamplerCreateInfo samplerCI{};
         samplerCI.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -92,9 +201,21 @@ namespace Eos
         samplerCI.addressModeU = addressMode;
         samplerCI.addressModeV = addressMode;
         samplerCI.addressModeW = addressMode;
+        samplerCI.mipmapMode = filter == VK_FILTER_LINEAR ?
+            VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        // The image view bounds the levels, so textures with a different
+        // number of levels can share the sampler
+        samplerCI.minLod = 0.0f;
+        samplerCI.maxLod = VK_LOD_CLAMP_NONE;
+
+        float maxAnisotropy = GlobalData::getMaxSamplerAnisotropy();
+        if (enableAnisotropy && maxAnisotropy > 1.0f)
+        {
+            samplerCI.anisotropyEnable = VK_TRUE;
+            samplerCI.maxAnisotropy = maxAnisotropy;
+        }
 
-        VkSampler sampler;
-        EOS_VK_CHECK(vkCreateSampler(Eos::GlobalData::getDevice(), &samplerCI, nullptr, &sampler));
+        VkSampler sampler = GlobalData::getSamplerCache().createSampler(&samplerCI);
 
         this->sampler = std::make_optional(sampler);
     }
@@ -104,29 +225,36 @@ namespace Eos
         m_AddedToDeletionQueue = true;
         m_DeletionQueue = &queue;
         m_DeletionQueueIndex = queue.pushFunction([&]() {
-            vkDestroyImageView(GlobalData::getDevice(), imageView, nullptr);
-            vmaDestroyImage(GlobalData::getAllocator(), image, allocation);
+            GlobalData::getDescriptorSetCache().invalidate(imageView);
+            GlobalData::getMemoryStats().untrack(allocation);
 
-            if (sampler.has_value())
-            {
-                vkDestroySampler(GlobalData::getDevice(), sampler.value(), nullptr);
-            }
+            vkDestroyImageView(GlobalData::getDevice(), imageView, nullptr);
+            GlobalData::getDefragmenter().destroyImage(image, allocation);
             sampler.reset();
+
+            image = VK_NULL_HANDLE;
+            imageView = VK_NULL_HANDLE;
+            m_AddedToDeletionQueue = false;
         });
     }
 
     void Texture2D::deleteImage()
     {
+        if (image == VK_NULL_HANDLE)
+            return;
+
+        GlobalData::getDescriptorSetCache().invalidate(imageView);
+
         if (!m_AddedToDeletionQueue)
         {
+            GlobalData::getMemoryStats().untrack(allocation);
+
             vkDestroyImageView(GlobalData::getDevice(), imageView, nullptr);
-            vmaDestroyImage(GlobalData::getAllocator(), image, allocation);
+            GlobalData::getDefragmenter().destroyImage(image, allocation);
+            sampler.reset();
 
-            if (sampler.has_value())
-            {
-                vkDestroySampler(GlobalData::getDevice(), sampler.value(), nullptr);
-                sampler.reset();
-            }
+            image = VK_NULL_HANDLE;
+            imageView = VK_NULL_HANDLE;
         }
         else
         {
@@ -136,40 +264,83 @@ namespace Eos
         }
     }
 
+    void Texture2D::transition(VkCommandBuffer cmd, const ImageAccess& access,
+            uint32_t baseMipLevel, uint32_t levelCount, uint32_t baseArrayLayer,
+            uint32_t layerCount)
+    {
+        VkImageSubresourceRange range;
+        range.aspectMask = aspectFlags;
+        range.baseMipLevel = baseMipLevel;
+        range.levelCount = levelCount;
+        range.baseArrayLayer = baseArrayLayer;
+        range.layerCount = layerCount;
+
+        std::vector<VkImageMemoryBarrier> barriers;
+        VkPipelineStageFlags srcStage = imageState.getBarriers(image, range, access, barriers);
+
+        if (barriers.empty())
+            return;
+
+        vkCmdPipelineBarrier(cmd, srcStage, access.stage, 0, 0, nullptr, 0, nullptr,
+                barriers.size(), barriers.data());
+    }
+
+    void Texture2D::transition(const ImageAccess& access, uint32_t baseMipLevel,
+            uint32_t levelCount, uint32_t baseArrayLayer, uint32_t layerCount)
+    {
+        GraphicsSubmit::submit([&](VkCommandBuffer cmd) {
+            transition(cmd, access, baseMipLevel, levelCount, baseArrayLayer, layerCount);
+        });
+    }
+
     void Texture2D::convertImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout,
             VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkPipelineStageFlags srcStage,
             VkPipelineStageFlags dstStage)
     {
         GraphicsSubmit::submit([&](VkCommandBuffer cmd){
-            VkImageSubresourceRange range;
-            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            range.baseMipLevel = 0;
-            range.levelCount = 1;
-            range.baseArrayLayer = 0;
-            range.layerCount = 1;
-
-            VkImageMemoryBarrier imageBarrier{};
-            imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            imageBarrier.oldLayout = oldLayout;
-            imageBarrier.newLayout = newLayout;
-            imageBarrier.image = image;
-            imageBarrier.subresourceRange = range;
-            imageBarrier.srcAccessMask = srcAccess;
-            imageBarrier.dstAccessMask = dstAccess;
-
-            vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr,
-                    1, &imageBarrier);
+            convertImageLayout(cmd, oldLayout, newLayout, srcAccess, dstAccess,
+                    srcStage, dstStage);
         });
     }
 
+    void Texture2D::convertImageLayout(VkCommandBuffer cmd, VkImageLayout oldLayout,
+            VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+            VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
+    {
+        VkImageSubresourceRange range;
+        range.aspectMask = aspectFlags;
+        range.baseMipLevel = 0;
+        range.levelCount = mipLevels;
+        range.baseArrayLayer = 0;
+        range.layerCount = arrayLayers;
+
+        VkImageMemoryBarrier imageBarrier{};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.oldLayout = oldLayout;
+        imageBarrier.newLayout = newLayout;
+        imageBarrier.image = image;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.subresourceRange = range;
+        imageBarrier.srcAccessMask = srcAccess;
+        imageBarrier.dstAccessMask = dstAccess;
+
+        vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr,
+                1, &imageBarrier);
+
+        imageState.set({ newLayout, dstAccess, dstStage });
+    }
+
     void Texture2D::convertImageLayout(VkImageLayout newLayout,
             VkAccessFlags dstAccess, VkPipelineStageFlags dstStage)
     {
-        convertImageLayout(
-            currentImageLayout, newLayout,
-            currentAccessFlag, dstAccess,
-            currentStage, dstStage
-        );
+        transition({ newLayout, dstAccess, dstStage });
+    }
+
+    void Texture2D::convertImageLayout(VkCommandBuffer cmd, VkImageLayout newLayout,
+            VkAccessFlags dstAccess, VkPipelineStageFlags dstStage)
+    {
+        transition(cmd, { newLayout, dstAccess, dstStage });
     }
 
     void Texture2D::transferDataToImage(const std::vector<uint32_t>& data)
@@ -189,8 +360,7 @@ namespace Eos
 
         transferBufferToImage(stagingBuffer);
 
-        vmaDestroyBuffer(Eos::GlobalData::getAllocator(), stagingBuffer.buffer,
-                stagingBuffer.allocation);
+        stagingBuffer.destroy();
     }
 
     void Texture2D::blitBetween(
@@ -198,49 +368,56 @@ namespace Eos
         Texture2D& dstTexture, VkImageLayout dstLayout, VkFilter filter)
     {
         GraphicsSubmit::submit([&](VkCommandBuffer cmd) {
-            VkImageSubresourceLayers src;
-            src.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            src.mipLevel = 0;
-            src.baseArrayLayer = 0;
-            src.layerCount = 1;
-
-            VkOffset3D srcOffsets[2];
-            srcOffsets[0] = { 0, 0, 0 };
-            srcOffsets[1] = {
-                static_cast<int32_t>(srcTexture.extent.width),
-                static_cast<int32_t>(srcTexture.extent.height),
-                1
-            };
-
-            VkImageSubresourceLayers dst;
-            dst.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            dst.mipLevel = 0;
-            dst.baseArrayLayer = 0;
-            dst.layerCount = 1;
-
-            VkOffset3D dstOffsets[2];
-            dstOffsets[0] = { 0, 0, 0 };
-            dstOffsets[1] = {
-                static_cast<int32_t>(dstTexture.extent.width),
-                static_cast<int32_t>(dstTexture.extent.height),
-                1
-            };
-
-            VkImageBlit region{};
-            region.srcSubresource = src;
-            region.dstSubresource = dst;
-            region.srcOffsets[0] = srcOffsets[0];
-            region.srcOffsets[1] = srcOffsets[1];
-            region.dstOffsets[0] = dstOffsets[0];
-            region.dstOffsets[1] = dstOffsets[1];
-
-            vkCmdBlitImage(cmd,
-                    srcTexture.image, srcLayout,
-                    dstTexture.image, dstLayout,
-                    1, &region, filter);
+            blitBetween(cmd, srcTexture, srcLayout, dstTexture, dstLayout, filter);
         });
     }
 
+    void Texture2D::blitBetween(VkCommandBuffer cmd,
+        Texture2D& srcTexture, VkImageLayout srcLayout,
+        Texture2D& dstTexture, VkImageLayout dstLayout, VkFilter filter)
+    {
+        VkImageSubresourceLayers src;
+        src.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        src.mipLevel = 0;
+        src.baseArrayLayer = 0;
+        src.layerCount = 1;
+
+        VkOffset3D srcOffsets[2];
+        srcOffsets[0] = { 0, 0, 0 };
+        srcOffsets[1] = {
+            static_cast<int32_t>(srcTexture.extent.width),
+            static_cast<int32_t>(srcTexture.extent.height),
+            1
+        };
+
+        VkImageSubresourceLayers dst;
+        dst.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        dst.mipLevel = 0;
+        dst.baseArrayLayer = 0;
+        dst.layerCount = 1;
+
+        VkOffset3D dstOffsets[2];
+        dstOffsets[0] = { 0, 0, 0 };
+        dstOffsets[1] = {
+            static_cast<int32_t>(dstTexture.extent.width),
+            static_cast<int32_t>(dstTexture.extent.height),
+            1
+        };
+
+        VkImageBlit region{};
+        region.srcSubresource = src;
+        region.dstSubresource = dst;
+        region.srcOffsets[0] = srcOffsets[0];
+        region.srcOffsets[1] = srcOffsets[1];
+        region.dstOffsets[0] = dstOffsets[0];
+        region.dstOffsets[1] = dstOffsets[1];
+
+        vkCmdBlitImage(cmd,
+                srcTexture.image, srcLayout,
+                dstTexture.image, dstLayout,
+                1, &region, filter);
+    }
+
     void Texture2D::createImage(VkImageUsageFlags usageFlags, VmaMemoryUsage memoryUsage,
             VkMemoryPropertyFlags memoryFlags)
     {
@@ -250,12 +427,14 @@ namespace Eos
         info.imageType = VK_IMAGE_TYPE_2D;
         info.format = format;
         info.extent = extent;
-        info.mipLevels = 1;
-        info.arrayLayers = 1;
+        info.mipLevels = mipLevels;
+        info.arrayLayers = arrayLayers;
         info.samples = VK_SAMPLE_COUNT_1_BIT;
         info.tiling = VK_IMAGE_TILING_OPTIMAL;
         info.usage = usageFlags;
 
+        usage = usageFlags;
+
         VmaAllocationCreateInfo vmaAllocInfo{};
         vmaAllocInfo.usage = memoryUsage;
         vmaAllocInfo.requiredFlags = VkMemoryPropertyFlags(memoryFlags);
@@ -263,58 +442,198 @@ namespace Eos
         EOS_VK_CHECK(vmaCreateImage(GlobalData::getAllocator(),
                     &info, &vmaAllocInfo, &image,
                     &allocation, nullptr));
+
+        GlobalData::getMemoryStats().track(MemoryCategory::Texture, allocation);
+
+        imageState.init(mipLevels, arrayLayers);
     }
 
     void Texture2D::transferBufferToImage(Buffer& stagingBuffer)
+    {
+        VkBufferImageCopy copyRegion{};
+        copyRegion.bufferOffset = 0;
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.mipLevel = 0;
+        copyRegion.imageSubresource.baseArrayLayer = 0;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageExtent = extent;
+
+        transferBufferToImage(stagingBuffer, { copyRegion });
+    }
+
+    void Texture2D::transferBufferToImage(Buffer& stagingBuffer,
+            const std::vector<VkBufferImageCopy>& regions)
     {
         GraphicsSubmit::submit([&](VkCommandBuffer cmd) {
-            VkImageSubresourceRange range;
-            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            range.baseMipLevel = 0;
-            range.levelCount = 1;
-            range.baseArrayLayer = 0;
-            range.layerCount = 1;
-
-            VkImageMemoryBarrier imageBarrierToTransfer{};
-            imageBarrierToTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            imageBarrierToTransfer.oldLayout = currentImageLayout;
-            imageBarrierToTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imageBarrierToTransfer.image = image;
-            imageBarrierToTransfer.subresourceRange = range;
-            imageBarrierToTransfer.srcAccessMask = currentAccessFlag;
-            imageBarrierToTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-            vkCmdPipelineBarrier(cmd, currentStage,
-                    VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr,
-                    0, nullptr, 1, &imageBarrierToTransfer);
+            recordBufferToImage(cmd, stagingBuffer.buffer, regions);
+        });
+    }
 
-            VkBufferImageCopy copyRegion{};
-            copyRegion.bufferOffset = 0;
-            copyRegion.bufferRowLength = 0;
-            copyRegion.bufferImageHeight = 0;
-            copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            copyRegion.imageSubresource.mipLevel = 0;
-            copyRegion.imageSubresource.baseArrayLayer = 0;
-            copyRegion.imageSubresource.layerCount = 1;
-            copyRegion.imageExtent = extent;
+    void Texture2D::recordBufferToImage(VkCommandBuffer cmd, VkBuffer buffer,
+            const std::vector<VkBufferImageCopy>& regions)
+    {
+        transition(cmd, Access::TransferDst);
 
-            vkCmdCopyBufferToImage(cmd, stagingBuffer.buffer, image,
-                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+        vkCmdCopyBufferToImage(cmd, buffer, image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
 
-            VkImageMemoryBarrier imageBarrierToReadable = imageBarrierToTransfer;
-            imageBarrierToReadable.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imageBarrierToReadable.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        // Levels that were not uploaded are generated from level 0
+        if (regions.size() < mipLevels)
+            recordMipmapGeneration(cmd);
+        else
+            transition(cmd, Access::FragmentShaderRead);
+    }
 
-            imageBarrierToReadable.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imageBarrierToReadable.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    void Texture2D::generateMipmaps()
+    {
+        if (mipLevels <= 1)
+            return;
 
-            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr,
-                    1, &imageBarrierToReadable);
+        GraphicsSubmit::submit([&](VkCommandBuffer cmd) {
+            // Level 0 keeps its contents, the remaining levels are overwritten
+            imageState.set({ aspectFlags, 1, VK_REMAINING_MIP_LEVELS, 0,
+                    VK_REMAINING_ARRAY_LAYERS }, Access::Undefined);
+            transition(cmd, Access::TransferDst);
+
+            recordMipmapGeneration(cmd);
         });
+    }
+
+    uint32_t Texture2D::calculateMipLevels(VkExtent3D extent)
+    {
+        uint32_t largest = std::max(extent.width, extent.height);
+
+        uint32_t levels = 1;
+        while (largest > 1)
+        {
+            largest >>= 1;
+            levels++;
+        }
+
+        return levels;
+    }
+
+    uint32_t Texture2D::getTexelSize(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8_UNORM:
+        case VK_FORMAT_R8_UINT:
+            return 1;
+
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_R32_SFLOAT:
+        case VK_FORMAT_R32_UINT:
+        case VK_FORMAT_D32_SFLOAT:
+            return 4;
+
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+        case VK_FORMAT_R32G32_SFLOAT:
+            return 8;
+
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return 16;
+
+        default:
+            return 0;
+        }
+    }
+
+    bool Texture2D::supportsMipGeneration(VkFormat format)
+    {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(GlobalData::getPhysicalDevice(), format,
+                &formatProperties);
+
+        VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+            VK_FORMAT_FEATURE_BLIT_DST_BIT;
+
+        return (formatProperties.optimalTilingFeatures & required) == required;
+    }
+
+    void Texture2D::recordMipmapGeneration(VkCommandBuffer cmd)
+    {
+        // Expects every level in TRANSFER_DST_OPTIMAL with level 0 written.
+        // Each level is blitted from the one above it, then all of them are
+        // made shader readable through the image state
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(GlobalData::getPhysicalDevice(), format,
+                &formatProperties);
+
+        if (!supportsMipGeneration(format))
+        {
+            // The loaders check this before creating levels, so only images
+            // created elsewhere get here. Their lower levels keep no contents
+            EOS_CORE_LOG_WARN("Format {} can not be blitted, mip levels were not generated",
+                    format);
+
+            transition(cmd, Access::FragmentShaderRead);
+            return;
+        }
+
+        VkFilter filter = VK_FILTER_NEAREST;
+        if (formatProperties.optimalTilingFeatures &
+                VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+            filter = VK_FILTER_LINEAR;
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.image = image;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = arrayLayers;
+        barrier.subresourceRange.levelCount = 1;
+
+        int32_t mipWidth = extent.width;
+        int32_t mipHeight = extent.height;
+
+        for (uint32_t i = 1; i < mipLevels; i++)
+        {
+            barrier.subresourceRange.baseMipLevel = i - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            int32_t nextWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            int32_t nextHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+
+            VkImageBlit region{};
+            region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.srcSubresource.mipLevel = i - 1;
+            region.srcSubresource.baseArrayLayer = 0;
+            region.srcSubresource.layerCount = arrayLayers;
+            region.srcOffsets[0] = { 0, 0, 0 };
+            region.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+            region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.dstSubresource.mipLevel = i;
+            region.dstSubresource.baseArrayLayer = 0;
+            region.dstSubresource.layerCount = arrayLayers;
+            region.dstOffsets[0] = { 0, 0, 0 };
+            region.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+
+            vkCmdBlitImage(cmd,
+                    image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    1, &region, filter);
+
+            mipWidth = nextWidth;
+            mipHeight = nextHeight;
+        }
+
+        imageState.set({ aspectFlags, 0, mipLevels - 1, 0, arrayLayers }, Access::TransferSrc);
+        imageState.set({ aspectFlags, mipLevels - 1, 1, 0, arrayLayers }, Access::TransferDst);
 
-        currentImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        currentStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        currentAccessFlag = VK_ACCESS_SHADER_READ_BIT;
+        transition(cmd, Access::FragmentShaderRead);
     }
 }
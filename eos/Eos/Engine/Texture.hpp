@@ -5,6 +5,7 @@
 #include "Eos/Engine/GlobalData.hpp"
 
 #include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/ImageState.hpp"
 
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
@@ -15,46 +16,99 @@ namespace Eos
     class EOS_API Texture2D
     {
     public:
-        VkImage image;
-        VkImageView imageView;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView imageView = VK_NULL_HANDLE;
+        // Owned by the engine's sampler cache and shared between textures
         std::optional<VkSampler> sampler;
 
         VkFormat format;
         VkExtent3D extent;
-        VmaAllocation allocation;
-
-        VkImageLayout currentImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        VkPipelineStageFlags currentStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        VkAccessFlags currentAccessFlag = 0;
+        uint32_t mipLevels = 1;
+        uint32_t arrayLayers = 1;
+        VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
+        VkImageUsageFlags usage = 0;
+
+        // Parameters of the current view, used when the image is recreated
+        VkFormat viewFormat;
+        VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+
+        // Last layout, access and stage of every mip level and array layer
+        ImageState imageState;
     public:
         Texture2D() {}
         ~Texture2D() { deleteImage(); }
 
-        void loadFromFile(const char* file);
+        void loadFromFile(const char* file, bool generateMips = true);
+
+        // Decodes the file and creates the image, view and sampler, leaving the
+        // pixels in stagingBuffer. Safe to call from worker threads
+        bool prepareFromFile(const char* file, bool generateMips, Buffer& stagingBuffer,
+                std::vector<VkBufferImageCopy>& regions);
+
+        // Records the copy from a prepared staging buffer, leaving the image
+        // shader readable
+        void recordBufferToImage(VkCommandBuffer cmd, VkBuffer buffer,
+                const std::vector<VkBufferImageCopy>& regions);
 
         void createImage(VkFormat format, VkImageUsageFlags usageFlags, VkExtent3D extent,
-                VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags memoryFlags = 0);
+                VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags memoryFlags = 0,
+                uint32_t mipLevels = 1, uint32_t arrayLayers = 1);
 
         void createImageView(VkImageAspectFlags flags);
         void createImageView(VkFormat format, VkImageAspectFlags flags);
 
-        void createSampler(VkFilter filter, VkSamplerAddressMode addressMode);
+        void createSampler(VkFilter filter, VkSamplerAddressMode addressMode,
+                bool enableAnisotropy = true);
+
+        // Fills every level from level 0. The image needs both transfer
+        // source and destination usage
+        void generateMipmaps();
+
+        static uint32_t calculateMipLevels(VkExtent3D extent);
+
+        // Mip chains are generated with blits, which the format has to support
+        // as both source and destination with optimal tiling
+        static bool supportsMipGeneration(VkFormat format);
+
+        // Bytes per texel of uncompressed formats, 0 for formats not listed
+        static uint32_t getTexelSize(VkFormat format);
 
         void addToDeletionQueue(DeletionQueue& queue);
         void deleteImage();
 
+        // Records the barriers needed to use the given levels and layers with
+        // access, based on the tracked state. Nothing is recorded when they
+        // are already usable
+        void transition(VkCommandBuffer cmd, const ImageAccess& access,
+                uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS,
+                uint32_t baseArrayLayer = 0, uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+        void transition(const ImageAccess& access,
+                uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS,
+                uint32_t baseArrayLayer = 0, uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+
+        // The overloads without a command buffer submit and wait, the others
+        // only record into cmd
         void convertImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout,
                 VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkPipelineStageFlags srcStage,
                 VkPipelineStageFlags dstStage);
+        void convertImageLayout(VkCommandBuffer cmd, VkImageLayout oldLayout,
+                VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage);
 
         void convertImageLayout(VkImageLayout newLayout,
                 VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+        void convertImageLayout(VkCommandBuffer cmd, VkImageLayout newLayout,
+                VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
 
         void transferDataToImage(const std::vector<uint32_t>& data);
 
         static void blitBetween(
                 Texture2D& srcTexture, VkImageLayout srcLayout,
                 Texture2D& dstTexture, VkImageLayout dstLayout, VkFilter filter);
+        static void blitBetween(VkCommandBuffer cmd,
+                Texture2D& srcTexture, VkImageLayout srcLayout,
+                Texture2D& dstTexture, VkImageLayout dstLayout, VkFilter filter);
 
     private:
         bool m_AddedToDeletionQueue = false;
@@ -65,5 +119,12 @@ namespace Eos
                 VkMemoryPropertyFlags memoryFlags = 0);
 
         void transferBufferToImage(Buffer& stagingBuffer);
+        void transferBufferToImage(Buffer& stagingBuffer,
+                const std::vector<VkBufferImageCopy>& regions);
+
+        bool prepareFromContainer(const char* file, bool generateMips, Buffer& stagingBuffer,
+                std::vector<VkBufferImageCopy>& regions);
+
+        void recordMipmapGeneration(VkCommandBuffer cmd);
     };
 }
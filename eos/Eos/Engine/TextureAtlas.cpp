@@ -0,0 +1,421 @@
+#include "TextureAtlas.hpp"
+
+#include "Eos/Engine/GlobalData.hpp"
+
+#include "Eos/Engine/Submits/GraphicsSubmit.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Eos
+{
+    void TextureAtlas::create(uint32_t size, uint32_t maxLayers, uint32_t padding,
+            VkFormat format)
+    {
+        m_TexelSize = Texture2D::getTexelSize(format);
+        if (m_TexelSize == 0)
+        {
+            EOS_CORE_LOG_ERROR("Texture atlas format {} is not supported", format);
+            return;
+        }
+
+        m_Size = size;
+        m_MaxLayers = maxLayers;
+        m_Padding = padding;
+        m_Format = format;
+
+        createTexture(*m_Texture, std::min(maxLayers, 1u));
+
+        // Padding is sampled by linear filtering, so it has to be cleared
+        GraphicsSubmit::submit([&](VkCommandBuffer cmd) {
+            m_Texture->transition(cmd, Access::TransferDst);
+
+            VkClearColorValue clearColour{};
+
+            VkImageSubresourceRange range;
+            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            range.baseMipLevel = 0;
+            range.levelCount = 1;
+            range.baseArrayLayer = 0;
+            range.layerCount = m_Texture->arrayLayers;
+
+            vkCmdClearColorImage(cmd, m_Texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    &clearColour, 1, &range);
+
+            m_Texture->transition(cmd, Access::FragmentShaderRead);
+        });
+    }
+
+    void TextureAtlas::destroy()
+    {
+        m_Texture->deleteImage();
+
+        m_Layers.clear();
+        m_Pending.clear();
+    }
+
+    std::optional<AtlasRegion> TextureAtlas::add(const char* file)
+    {
+        if (!isRgba8())
+        {
+            EOS_CORE_LOG_ERROR("Files can only be added to RGBA8 atlases, atlas format is {}",
+                    m_Format);
+            return std::nullopt;
+        }
+
+        int width;
+        int height;
+        int channels;
+
+        stbi_uc* pixels = stbi_load(file, &width, &height, &channels, STBI_rgb_alpha);
+
+        if (!pixels)
+        {
+            EOS_CORE_LOG_ERROR("Failed to load Texture {}", file);
+            return std::nullopt;
+        }
+
+        std::optional<AtlasRegion> region = add(pixels, width, height);
+
+        stbi_image_free(pixels);
+
+        return region;
+    }
+
+    std::optional<AtlasRegion> TextureAtlas::add(const uint8_t* pixels, uint32_t width,
+            uint32_t height)
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t layer;
+
+        if (!pack(width, height, x, y, layer))
+        {
+            EOS_CORE_LOG_WARN("Texture atlas is full, could not fit {}x{} image", width, height);
+            return std::nullopt;
+        }
+
+        PendingImage image;
+        image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * m_TexelSize);
+        image.x = x;
+        image.y = y;
+        image.width = width;
+        image.height = height;
+        image.layer = layer;
+
+        m_Pending.push_back(std::move(image));
+
+        float size = static_cast<float>(m_Size);
+
+        AtlasRegion region;
+        region.uvMin = { x / size, y / size };
+        region.uvMax = { (x + width) / size, (y + height) / size };
+        region.layer = layer;
+        region.x = x;
+        region.y = y;
+        region.width = width;
+        region.height = height;
+
+        return region;
+    }
+
+    std::vector<std::optional<AtlasRegion>> TextureAtlas::addBatch(
+            const std::vector<std::string>& files)
+    {
+        if (!isRgba8())
+        {
+            EOS_CORE_LOG_ERROR("Files can only be added to RGBA8 atlases, atlas format is {}",
+                    m_Format);
+            return std::vector<std::optional<AtlasRegion>>(files.size());
+        }
+
+        struct LoadedImage
+        {
+            stbi_uc* pixels;
+            int width;
+            int height;
+        };
+
+        std::vector<LoadedImage> images(files.size());
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            int channels;
+            images[i].pixels = stbi_load(files[i].c_str(), &images[i].width, &images[i].height,
+                    &channels, STBI_rgb_alpha);
+
+            if (!images[i].pixels)
+                EOS_CORE_LOG_ERROR("Failed to load Texture {}", files[i]);
+        }
+
+        std::vector<size_t> order(files.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                if (images[a].height != images[b].height)
+                    return images[a].height > images[b].height;
+                return images[a].width > images[b].width;
+            });
+
+        std::vector<std::optional<AtlasRegion>> regions(files.size());
+        for (size_t index : order)
+        {
+            LoadedImage& image = images[index];
+            if (!image.pixels)
+                continue;
+
+            regions[index] = add(image.pixels, image.width, image.height);
+
+            stbi_image_free(image.pixels);
+        }
+
+        return regions;
+    }
+
+    void TextureAtlas::upload()
+    {
+        if (m_Pending.empty())
+            return;
+
+        if (m_Layers.size() > m_Texture->arrayLayers)
+            grow(static_cast<uint32_t>(m_Layers.size()));
+
+        size_t totalSize = 0;
+        for (PendingImage& image : m_Pending)
+            totalSize += image.pixels.size();
+
+        Buffer stagingBuffer;
+        stagingBuffer.create(totalSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VMA_MEMORY_USAGE_CPU_ONLY);
+
+        std::vector<VkBufferImageCopy> regions;
+        regions.reserve(m_Pending.size());
+
+        void* data;
+        vmaMapMemory(GlobalData::getAllocator(), stagingBuffer.allocation, &data);
+
+        size_t offset = 0;
+        for (PendingImage& image : m_Pending)
+        {
+            memcpy(static_cast<uint8_t*>(data) + offset, image.pixels.data(),
+                    image.pixels.size());
+
+            VkBufferImageCopy copyRegion{};
+            copyRegion.bufferOffset = offset;
+            copyRegion.bufferRowLength = 0;
+            copyRegion.bufferImageHeight = 0;
+            copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.imageSubresource.mipLevel = 0;
+            copyRegion.imageSubresource.baseArrayLayer = image.layer;
+            copyRegion.imageSubresource.layerCount = 1;
+            copyRegion.imageOffset = {
+                static_cast<int32_t>(image.x), static_cast<int32_t>(image.y), 0
+            };
+            copyRegion.imageExtent = { image.width, image.height, 1 };
+
+            regions.push_back(copyRegion);
+            offset += image.pixels.size();
+        }
+
+        vmaUnmapMemory(GlobalData::getAllocator(), stagingBuffer.allocation);
+
+        // Only the layers being written are transitioned, existing regions
+        // keep their contents as the tracked layout is preserved
+        uint32_t firstLayer = m_Pending.front().layer;
+        uint32_t lastLayer = firstLayer;
+        for (const PendingImage& image : m_Pending)
+        {
+            firstLayer = std::min(firstLayer, image.layer);
+            lastLayer = std::max(lastLayer, image.layer);
+        }
+
+        GraphicsSubmit::submit([&](VkCommandBuffer cmd) {
+            m_Texture->transition(cmd, Access::TransferDst, 0, 1, firstLayer,
+                    lastLayer - firstLayer + 1);
+
+            vkCmdCopyBufferToImage(cmd, stagingBuffer.buffer, m_Texture->image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+
+            m_Texture->transition(cmd, Access::FragmentShaderRead, 0, 1, firstLayer,
+                    lastLayer - firstLayer + 1);
+        });
+
+        stagingBuffer.destroy();
+
+        m_Pending.clear();
+    }
+
+    void TextureAtlas::createTexture(Texture2D& texture, uint32_t layers)
+    {
+        texture.createImage(m_Format,
+                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                { m_Size, m_Size, 1 }, VMA_MEMORY_USAGE_GPU_ONLY, 0, 1, layers);
+
+        // Always an array view so shaders can use sampler2DArray regardless
+        // of how many layers are in use
+        texture.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+        texture.createImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+        texture.createSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false);
+    }
+
+    bool TextureAtlas::isRgba8() const
+    {
+        return m_Format == VK_FORMAT_R8G8B8A8_UNORM || m_Format == VK_FORMAT_R8G8B8A8_SRGB;
+    }
+
+    void TextureAtlas::grow(uint32_t layers)
+    {
+        uint32_t oldLayers = m_Texture->arrayLayers;
+
+        uint32_t newLayers = oldLayers;
+        while (newLayers < layers)
+            newLayers *= 2;
+        newLayers = std::min(newLayers, m_MaxLayers);
+
+        std::unique_ptr<Texture2D> texture = std::make_unique<Texture2D>();
+        createTexture(*texture, newLayers);
+
+        GraphicsSubmit::submit([&](VkCommandBuffer cmd) {
+            m_Texture->transition(cmd, Access::TransferSrc);
+            texture->transition(cmd, Access::TransferDst);
+
+            VkImageCopy copyRegion{};
+            copyRegion.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, oldLayers };
+            copyRegion.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, oldLayers };
+            copyRegion.extent = { m_Size, m_Size, 1 };
+
+            vkCmdCopyImage(cmd, m_Texture->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+            VkClearColorValue clearColour{};
+
+            VkImageSubresourceRange range;
+            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            range.baseMipLevel = 0;
+            range.levelCount = 1;
+            range.baseArrayLayer = oldLayers;
+            range.layerCount = newLayers - oldLayers;
+
+            vkCmdClearColorImage(cmd, texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    &clearColour, 1, &range);
+
+            texture->transition(cmd, Access::FragmentShaderRead);
+        });
+
+        // Frames in flight may still sample the old image
+        vkDeviceWaitIdle(GlobalData::getDevice());
+
+        m_Texture = std::move(texture);
+
+        EOS_CORE_LOG_INFO("Texture atlas grew to {} layers", newLayers);
+    }
+
+    bool TextureAtlas::pack(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y,
+            uint32_t& layer)
+    {
+        if (width == 0 || height == 0 || width > m_Size || height > m_Size)
+            return false;
+
+        // Padding is only kept between images, not against the atlas edge
+        uint32_t paddedWidth = std::min(width + m_Padding, m_Size);
+        uint32_t paddedHeight = std::min(height + m_Padding, m_Size);
+
+        size_t index;
+        for (layer = 0; layer < m_Layers.size(); layer++)
+        {
+            if (findPosition(m_Layers[layer], paddedWidth, paddedHeight, x, y, index))
+            {
+                addSkylineLevel(m_Layers[layer], index, x, y, paddedWidth, paddedHeight);
+                return true;
+            }
+        }
+
+        if (m_Layers.size() >= m_MaxLayers)
+            return false;
+
+        m_Layers.push_back({ { 0, 0, m_Size } });
+        layer = m_Layers.size() - 1;
+
+        findPosition(m_Layers[layer], paddedWidth, paddedHeight, x, y, index);
+        addSkylineLevel(m_Layers[layer], index, x, y, paddedWidth, paddedHeight);
+
+        return true;
+    }
+
+    bool TextureAtlas::findPosition(const std::vector<SkylineNode>& skyline, uint32_t width,
+            uint32_t height, uint32_t& x, uint32_t& y, size_t& index)
+    {
+        // Bottom left rule, the position leaving the lowest top edge wins
+        uint32_t bestTop = UINT32_MAX;
+        uint32_t bestWidth = UINT32_MAX;
+        bool found = false;
+
+        for (size_t i = 0; i < skyline.size(); i++)
+        {
+            uint32_t nodeX = skyline[i].x;
+            if (nodeX + width > m_Size)
+                break;
+
+            uint32_t top = 0;
+            uint32_t remaining = width;
+            for (size_t j = i; remaining > 0; j++)
+            {
+                top = std::max(top, skyline[j].y);
+                remaining -= std::min(remaining, skyline[j].width);
+            }
+
+            if (top + height > m_Size)
+                continue;
+
+            if (top + height < bestTop ||
+                    (top + height == bestTop && skyline[i].width < bestWidth))
+            {
+                bestTop = top + height;
+                bestWidth = skyline[i].width;
+
+                x = nodeX;
+                y = top;
+                index = i;
+                found = true;
+            }
+        }
+
+        return found;
+    }
+
+    void TextureAtlas::addSkylineLevel(std::vector<SkylineNode>& skyline, size_t index,
+            uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        skyline.insert(skyline.begin() + index, { x, y + height, width });
+
+        // Trim or remove the nodes now covered by the new one
+        for (size_t i = index + 1; i < skyline.size();)
+        {
+            uint32_t previousEnd = skyline[i - 1].x + skyline[i - 1].width;
+            if (skyline[i].x >= previousEnd)
+                break;
+
+            uint32_t shrink = previousEnd - skyline[i].x;
+            if (skyline[i].width <= shrink)
+            {
+                skyline.erase(skyline.begin() + i);
+                continue;
+            }
+
+            skyline[i].x += shrink;
+            skyline[i].width -= shrink;
+            break;
+        }
+
+        for (size_t i = 0; i + 1 < skyline.size();)
+        {
+            if (skyline[i].y == skyline[i + 1].y)
+            {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+                continue;
+            }
+
+            i++;
+        }
+    }
+}
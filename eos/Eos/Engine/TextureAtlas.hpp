@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Texture.hpp"
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    struct AtlasRegion
+    {
+        glm::vec2 uvMin;
+        glm::vec2 uvMax;
+        uint32_t layer;
+
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Packs many small images into the layers of a single 2D array texture,
+    // so that sprites can share one binding. Images can be added at any time,
+    // new regions become visible once upload has been called.
+    //
+    // The texture starts with one layer and grows up to maxLayers as layers
+    // fill. Growing recreates the image, so descriptors have to be rebuilt
+    // from getTexture after an upload that added layers
+    class EOS_API TextureAtlas
+    {
+    public:
+        TextureAtlas() {}
+        ~TextureAtlas() { destroy(); }
+
+        void create(uint32_t size, uint32_t maxLayers, uint32_t padding = 1,
+                VkFormat format = VK_FORMAT_R8G8B8A8_SRGB);
+        void destroy();
+
+        // Files are decoded as RGBA8, so the atlas has to use an RGBA8 format
+        std::optional<AtlasRegion> add(const char* file);
+        // pixels are tightly packed texels in the atlas format
+        std::optional<AtlasRegion> add(const uint8_t* pixels, uint32_t width, uint32_t height);
+
+        // Packs largest first, which wastes less space than adding one at a time
+        std::vector<std::optional<AtlasRegion>> addBatch(const std::vector<std::string>& files);
+
+        // Copies every pending image into the texture in one submission
+        void upload();
+
+        Texture2D& getTexture() { return *m_Texture; }
+
+        uint32_t getLayerCount() const { return m_Layers.size(); }
+        size_t getPendingCount() const { return m_Pending.size(); }
+    private:
+        struct SkylineNode
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        struct PendingImage
+        {
+            std::vector<uint8_t> pixels;
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+            uint32_t height;
+            uint32_t layer;
+        };
+
+        std::unique_ptr<Texture2D> m_Texture = std::make_unique<Texture2D>();
+
+        uint32_t m_Size = 0;
+        uint32_t m_MaxLayers = 0;
+        uint32_t m_Padding = 0;
+
+        VkFormat m_Format = VK_FORMAT_UNDEFINED;
+        uint32_t m_TexelSize = 0;
+
+        // One skyline per layer in use
+        std::vector<std::vector<SkylineNode>> m_Layers;
+
+        std::vector<PendingImage> m_Pending;
+    private:
+        void createTexture(Texture2D& texture, uint32_t layers);
+        bool isRgba8() const;
+
+        // Recreates the texture with at least layers layers, keeping the
+        // contents of the existing ones
+        void grow(uint32_t layers);
+
+        bool pack(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y, uint32_t& layer);
+
+        bool findPosition(const std::vector<SkylineNode>& skyline, uint32_t width,
+                uint32_t height, uint32_t& x, uint32_t& y, size_t& index);
+        void addSkylineLevel(std::vector<SkylineNode>& skyline, size_t index, uint32_t x,
+                uint32_t y, uint32_t width, uint32_t height);
+    };
+}
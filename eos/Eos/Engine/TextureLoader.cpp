@@ -0,0 +1,801 @@
+#include "TextureLoader.hpp"
+
+#include "Eos/Engine/GlobalData.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace Eos
+{
+    namespace
+    {
+        const uint8_t KTX2_IDENTIFIER[12] = {
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+
+        struct KTX2Header
+        {
+            uint8_t identifier[12];
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint64_t sgdByteOffset;
+            uint64_t sgdByteLength;
+        };
+
+        struct KTX2LevelIndex
+        {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+
+        const uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+        const uint32_t DDS_ALPHAPIXELS = 0x1;
+        const uint32_t DDS_FOURCC = 0x4;
+        const uint32_t DDS_RGB = 0x40;
+
+        const uint32_t DDS_CAPS2_CUBEMAP = 0x200;
+        const uint32_t DDS_CAPS2_VOLUME = 0x200000;
+        const uint32_t DDS_RESOURCE_DIMENSION_TEXTURE2D = 3;
+        const uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+        struct DDSPixelFormat
+        {
+            uint32_t size;
+            uint32_t flags;
+            uint32_t fourCC;
+            uint32_t rgbBitCount;
+            uint32_t rBitMask;
+            uint32_t gBitMask;
+            uint32_t bBitMask;
+            uint32_t aBitMask;
+        };
+
+        struct DDSHeader
+        {
+            uint32_t size;
+            uint32_t flags;
+            uint32_t height;
+            uint32_t width;
+            uint32_t pitchOrLinearSize;
+            uint32_t depth;
+            uint32_t mipMapCount;
+            uint32_t reserved1[11];
+            DDSPixelFormat pixelFormat;
+            uint32_t caps;
+            uint32_t caps2;
+            uint32_t caps3;
+            uint32_t caps4;
+            uint32_t reserved2;
+        };
+
+        struct DDSHeaderDX10
+        {
+            uint32_t dxgiFormat;
+            uint32_t resourceDimension;
+            uint32_t miscFlag;
+            uint32_t arraySize;
+            uint32_t miscFlags2;
+        };
+
+        constexpr uint32_t makeFourCC(char a, char b, char c, char d)
+        {
+            return static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 |
+                static_cast<uint32_t>(c) << 16 | static_cast<uint32_t>(d) << 24;
+        }
+
+        VkFormat formatFromFourCC(uint32_t fourCC)
+        {
+            switch (fourCC)
+            {
+            case makeFourCC('D', 'X', 'T', '1'): return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case makeFourCC('D', 'X', 'T', '2'):
+            case makeFourCC('D', 'X', 'T', '3'): return VK_FORMAT_BC2_UNORM_BLOCK;
+            case makeFourCC('D', 'X', 'T', '4'):
+            case makeFourCC('D', 'X', 'T', '5'): return VK_FORMAT_BC3_UNORM_BLOCK;
+            case makeFourCC('A', 'T', 'I', '1'):
+            case makeFourCC('B', 'C', '4', 'U'): return VK_FORMAT_BC4_UNORM_BLOCK;
+            case makeFourCC('B', 'C', '4', 'S'): return VK_FORMAT_BC4_SNORM_BLOCK;
+            case makeFourCC('A', 'T', 'I', '2'):
+            case makeFourCC('B', 'C', '5', 'U'): return VK_FORMAT_BC5_UNORM_BLOCK;
+            case makeFourCC('B', 'C', '5', 'S'): return VK_FORMAT_BC5_SNORM_BLOCK;
+            default: return VK_FORMAT_UNDEFINED;
+            }
+        }
+
+        VkFormat formatFromDXGI(uint32_t dxgiFormat)
+        {
+            switch (dxgiFormat)
+            {
+            case 28: return VK_FORMAT_R8G8B8A8_UNORM;
+            case 29: return VK_FORMAT_R8G8B8A8_SRGB;
+            case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+            case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+            case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+            case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+            case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+            case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+            case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+            case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+            case 87: return VK_FORMAT_B8G8R8A8_UNORM;
+            case 91: return VK_FORMAT_B8G8R8A8_SRGB;
+            case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+            case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+            case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+            case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+            default: return VK_FORMAT_UNDEFINED;
+            }
+        }
+
+        // Copy regions must start on a multiple of the block size
+        size_t alignOffset(size_t offset)
+        {
+            return (offset + 15) & ~static_cast<size_t>(15);
+        }
+
+        // True when [offset, offset + length) lies within a buffer of size
+        bool isRangeValid(uint64_t offset, uint64_t length, size_t size)
+        {
+            return offset <= size && length <= size - offset;
+        }
+
+        // Bytes needed by a level, false if that does not fit in a size_t
+        bool calculateLevelSize(uint32_t width, uint32_t height, uint32_t blockWidth,
+                uint32_t blockHeight, uint32_t blockBytes, size_t& size)
+        {
+            uint64_t blocksX = (static_cast<uint64_t>(width) + blockWidth - 1) / blockWidth;
+            uint64_t blocksY = (static_cast<uint64_t>(height) + blockHeight - 1) / blockHeight;
+
+            // Both are below 2^32, so only the multiply by blockBytes can overflow
+            uint64_t blocks = blocksX * blocksY;
+            if (blocks > std::numeric_limits<size_t>::max() / blockBytes)
+                return false;
+
+            size = static_cast<size_t>(blocks * blockBytes);
+            return true;
+        }
+
+        uint32_t calculateMaxLevels(uint32_t width, uint32_t height)
+        {
+            uint32_t largest = std::max(width, height);
+
+            uint32_t levels = 1;
+            while (largest > 1)
+            {
+                largest >>= 1;
+                levels++;
+            }
+
+            return levels;
+        }
+    }
+
+    bool TextureLoader::isContainerFile(const char* file)
+    {
+        std::string path(file);
+        size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos)
+            return false;
+
+        std::string extension = path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                [](unsigned char c) { return std::tolower(c); });
+
+        return extension == "ktx2" || extension == "dds";
+    }
+
+    bool TextureLoader::load(const char* file, TextureData& textureData)
+    {
+        std::ifstream stream(file, std::ios::binary | std::ios::ate);
+        if (!stream.is_open())
+        {
+            EOS_CORE_LOG_ERROR("Failed to open Texture {}", file);
+            return false;
+        }
+
+        std::vector<uint8_t> contents(static_cast<size_t>(stream.tellg()));
+        stream.seekg(0);
+        stream.read(reinterpret_cast<char*>(contents.data()), contents.size());
+
+        bool success = false;
+        if (contents.size() >= sizeof(KTX2Header) &&
+                std::memcmp(contents.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0)
+        {
+            success = loadKTX2(contents, textureData);
+        }
+        else if (contents.size() >= sizeof(uint32_t) + sizeof(DDSHeader) &&
+                *reinterpret_cast<const uint32_t*>(contents.data()) == DDS_MAGIC)
+        {
+            success = loadDDS(contents, textureData);
+        }
+        else
+        {
+            EOS_CORE_LOG_ERROR("Texture {} is not a KTX2 or DDS file", file);
+            return false;
+        }
+
+        if (!success)
+            EOS_CORE_LOG_ERROR("Failed to load Texture {}", file);
+
+        return success;
+    }
+
+    bool TextureLoader::isFormatSupported(VkFormat format)
+    {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(GlobalData::getPhysicalDevice(), format, &properties);
+
+        return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) &&
+            (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_DST_BIT);
+    }
+
+    bool TextureLoader::isCompressedFormat(VkFormat format)
+    {
+        uint32_t blockWidth, blockHeight, blockBytes;
+        if (!getBlockInfo(format, blockWidth, blockHeight, blockBytes))
+            return false;
+
+        return blockWidth > 1;
+    }
+
+    bool TextureLoader::decodeToRGBA(TextureData& textureData)
+    {
+        VkFormat decodedFormat = VK_FORMAT_R8G8B8A8_UNORM;
+        switch (textureData.format)
+        {
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            decodedFormat = VK_FORMAT_R8G8B8A8_SRGB;
+            break;
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            break;
+        // Signed data keeps its sign, unused channels are 0 and alpha is 1
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+            decodedFormat = VK_FORMAT_R8G8B8A8_SNORM;
+            break;
+        default:
+            return false;
+        }
+
+        bool isSigned = decodedFormat == VK_FORMAT_R8G8B8A8_SNORM;
+
+        uint32_t blockWidth, blockHeight, blockBytes;
+        getBlockInfo(textureData.format, blockWidth, blockHeight, blockBytes);
+
+        std::vector<TextureLevel> levels;
+        std::vector<uint8_t> data;
+
+        for (const TextureLevel& level : textureData.levels)
+        {
+            size_t requiredSize;
+            if (!calculateLevelSize(level.width, level.height, blockWidth, blockHeight,
+                        blockBytes, requiredSize) || level.size < requiredSize ||
+                    !isRangeValid(level.offset, level.size, textureData.data.size()))
+            {
+                EOS_CORE_LOG_ERROR("Texture level is smaller than its size requires");
+                return false;
+            }
+
+            TextureLevel decoded;
+            decoded.offset = alignOffset(data.size());
+            decoded.width = level.width;
+            decoded.height = level.height;
+            decoded.size = static_cast<size_t>(level.width) * level.height * 4;
+
+            data.resize(decoded.offset + decoded.size);
+            uint8_t* out = data.data() + decoded.offset;
+
+            uint32_t blocksX = (level.width + 3) / 4;
+            uint32_t blocksY = (level.height + 3) / 4;
+
+            for (uint32_t by = 0; by < blocksY; by++)
+            {
+                for (uint32_t bx = 0; bx < blocksX; bx++)
+                {
+                    const uint8_t* block = textureData.data.data() + level.offset +
+                        (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+
+                    uint8_t texels[16 * 4];
+                    std::memset(texels, 0, sizeof(texels));
+                    for (uint32_t i = 0; i < 16; i++)
+                        texels[i * 4 + 3] = isSigned ? 127 : 255;
+
+                    switch (textureData.format)
+                    {
+                    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                        decodeColourBlock(block, texels, true, false);
+                        break;
+                    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+                    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                        decodeColourBlock(block, texels, true, true);
+                        break;
+                    case VK_FORMAT_BC2_UNORM_BLOCK:
+                    case VK_FORMAT_BC2_SRGB_BLOCK:
+                        decodeColourBlock(block + 8, texels, false, false);
+                        decodeExplicitAlphaBlock(block, texels);
+                        break;
+                    case VK_FORMAT_BC3_UNORM_BLOCK:
+                    case VK_FORMAT_BC3_SRGB_BLOCK:
+                        decodeColourBlock(block + 8, texels, false, false);
+                        decodeAlphaBlock(block, texels, 3);
+                        break;
+                    case VK_FORMAT_BC4_UNORM_BLOCK:
+                        decodeAlphaBlock(block, texels, 0);
+                        break;
+                    case VK_FORMAT_BC5_UNORM_BLOCK:
+                        decodeAlphaBlock(block, texels, 0);
+                        decodeAlphaBlock(block + 8, texels, 1);
+                        break;
+                    case VK_FORMAT_BC4_SNORM_BLOCK:
+                        decodeSignedAlphaBlock(block, texels, 0);
+                        break;
+                    case VK_FORMAT_BC5_SNORM_BLOCK:
+                        decodeSignedAlphaBlock(block, texels, 0);
+                        decodeSignedAlphaBlock(block + 8, texels, 1);
+                        break;
+                    default:
+                        break;
+                    }
+
+                    for (uint32_t y = 0; y < 4 && by * 4 + y < level.height; y++)
+                    {
+                        for (uint32_t x = 0; x < 4 && bx * 4 + x < level.width; x++)
+                        {
+                            size_t dst = (static_cast<size_t>(by * 4 + y) * level.width +
+                                    bx * 4 + x) * 4;
+                            std::memcpy(out + dst, texels + (y * 4 + x) * 4, 4);
+                        }
+                    }
+                }
+            }
+
+            levels.push_back(decoded);
+        }
+
+        textureData.format = decodedFormat;
+        textureData.levels = std::move(levels);
+        textureData.data = std::move(data);
+
+        return true;
+    }
+
+    bool TextureLoader::loadKTX2(const std::vector<uint8_t>& file, TextureData& textureData)
+    {
+        KTX2Header header;
+        std::memcpy(&header, file.data(), sizeof(KTX2Header));
+
+        if (header.vkFormat == 0 || header.supercompressionScheme != 0)
+        {
+            EOS_CORE_LOG_ERROR("Supercompressed KTX2 textures are not supported");
+            return false;
+        }
+
+        if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1)
+        {
+            EOS_CORE_LOG_ERROR("Only 2D KTX2 textures are supported");
+            return false;
+        }
+
+        VkFormat format = static_cast<VkFormat>(header.vkFormat);
+
+        uint32_t blockWidth, blockHeight, blockBytes;
+        if (!getBlockInfo(format, blockWidth, blockHeight, blockBytes))
+        {
+            EOS_CORE_LOG_ERROR("Unsupported KTX2 format {}", header.vkFormat);
+            return false;
+        }
+
+        if (header.pixelWidth == 0)
+        {
+            EOS_CORE_LOG_ERROR("KTX2 texture has no width");
+            return false;
+        }
+
+        uint32_t levelCount = std::max(header.levelCount, 1u);
+        if (levelCount > calculateMaxLevels(header.pixelWidth, std::max(header.pixelHeight, 1u)))
+        {
+            EOS_CORE_LOG_ERROR("KTX2 texture has more levels than its size allows");
+            return false;
+        }
+
+        // levelCount is at most 33, so this can not overflow
+        size_t indexEnd = sizeof(KTX2Header) + levelCount * sizeof(KTX2LevelIndex);
+        if (file.size() < indexEnd)
+            return false;
+
+        textureData.format = format;
+        textureData.extent = { header.pixelWidth, std::max(header.pixelHeight, 1u), 1 };
+        textureData.levels.clear();
+        textureData.data.clear();
+
+        for (uint32_t i = 0; i < levelCount; i++)
+        {
+            KTX2LevelIndex index;
+            std::memcpy(&index, file.data() + sizeof(KTX2Header) + i * sizeof(KTX2LevelIndex),
+                    sizeof(KTX2LevelIndex));
+
+            if (!isRangeValid(index.byteOffset, index.byteLength, file.size()))
+                return false;
+
+            TextureLevel level;
+            level.offset = alignOffset(textureData.data.size());
+            level.width = std::max(textureData.extent.width >> i, 1u);
+            level.height = std::max(textureData.extent.height >> i, 1u);
+
+            // Without supercompression a level holds exactly one 2D image
+            if (!calculateLevelSize(level.width, level.height, blockWidth, blockHeight,
+                        blockBytes, level.size) || index.byteLength != level.size)
+            {
+                EOS_CORE_LOG_ERROR("KTX2 level {} has {} bytes, expected {}", i,
+                        index.byteLength, level.size);
+                return false;
+            }
+
+            textureData.data.resize(level.offset + level.size);
+            std::memcpy(textureData.data.data() + level.offset,
+                    file.data() + index.byteOffset, level.size);
+
+            textureData.levels.push_back(level);
+        }
+
+        return true;
+    }
+
+    bool TextureLoader::loadDDS(const std::vector<uint8_t>& file, TextureData& textureData)
+    {
+        DDSHeader header;
+        std::memcpy(&header, file.data() + sizeof(uint32_t), sizeof(DDSHeader));
+
+        size_t dataOffset = sizeof(uint32_t) + sizeof(DDSHeader);
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        if (header.caps2 & (DDS_CAPS2_CUBEMAP | DDS_CAPS2_VOLUME))
+        {
+            EOS_CORE_LOG_ERROR("Only 2D DDS textures are supported");
+            return false;
+        }
+
+        if (header.pixelFormat.flags & DDS_FOURCC)
+        {
+            if (header.pixelFormat.fourCC == makeFourCC('D', 'X', '1', '0'))
+            {
+                if (file.size() < dataOffset + sizeof(DDSHeaderDX10))
+                    return false;
+
+                DDSHeaderDX10 headerDX10;
+                std::memcpy(&headerDX10, file.data() + dataOffset, sizeof(DDSHeaderDX10));
+                dataOffset += sizeof(DDSHeaderDX10);
+
+                if (headerDX10.arraySize > 1 ||
+                        headerDX10.resourceDimension != DDS_RESOURCE_DIMENSION_TEXTURE2D ||
+                        (headerDX10.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE))
+                {
+                    EOS_CORE_LOG_ERROR("Only 2D DDS textures are supported");
+                    return false;
+                }
+
+                format = formatFromDXGI(headerDX10.dxgiFormat);
+            }
+            else
+            {
+                format = formatFromFourCC(header.pixelFormat.fourCC);
+            }
+        }
+        else if ((header.pixelFormat.flags & DDS_RGB) &&
+                (header.pixelFormat.flags & DDS_ALPHAPIXELS) &&
+                header.pixelFormat.rgbBitCount == 32 &&
+                header.pixelFormat.aBitMask == 0xFF000000 &&
+                header.pixelFormat.gBitMask == 0x0000FF00)
+        {
+            // Every channel mask has to match, other layouts are left unsupported
+            if (header.pixelFormat.rBitMask == 0x000000FF &&
+                    header.pixelFormat.bBitMask == 0x00FF0000)
+                format = VK_FORMAT_R8G8B8A8_UNORM;
+            else if (header.pixelFormat.rBitMask == 0x00FF0000 &&
+                    header.pixelFormat.bBitMask == 0x000000FF)
+                format = VK_FORMAT_B8G8R8A8_UNORM;
+        }
+
+        if (format == VK_FORMAT_UNDEFINED)
+        {
+            EOS_CORE_LOG_ERROR("Unsupported DDS pixel format");
+            return false;
+        }
+
+        uint32_t blockWidth, blockHeight, blockBytes;
+        if (!getBlockInfo(format, blockWidth, blockHeight, blockBytes))
+        {
+            EOS_CORE_LOG_ERROR("Unsupported DDS pixel format");
+            return false;
+        }
+
+        if (header.width == 0 || header.height == 0)
+        {
+            EOS_CORE_LOG_ERROR("DDS texture has no size");
+            return false;
+        }
+
+        uint32_t levelCount = std::max(header.mipMapCount, 1u);
+        if (levelCount > calculateMaxLevels(header.width, header.height))
+        {
+            EOS_CORE_LOG_ERROR("DDS texture has more levels than its size allows");
+            return false;
+        }
+
+        textureData.format = format;
+        textureData.extent = { header.width, header.height, 1 };
+        textureData.levels.clear();
+        textureData.data.clear();
+
+        size_t fileOffset = dataOffset;
+
+        for (uint32_t i = 0; i < levelCount; i++)
+        {
+            TextureLevel level;
+            level.width = std::max(header.width >> i, 1u);
+            level.height = std::max(header.height >> i, 1u);
+            level.offset = alignOffset(textureData.data.size());
+
+            if (!calculateLevelSize(level.width, level.height, blockWidth, blockHeight,
+                        blockBytes, level.size) ||
+                    !isRangeValid(fileOffset, level.size, file.size()))
+                return false;
+
+            textureData.data.resize(level.offset + level.size);
+            std::memcpy(textureData.data.data() + level.offset, file.data() + fileOffset,
+                    level.size);
+
+            fileOffset += level.size;
+            textureData.levels.push_back(level);
+        }
+
+        return true;
+    }
+
+    bool TextureLoader::getBlockInfo(VkFormat format, uint32_t& blockWidth,
+            uint32_t& blockHeight, uint32_t& blockBytes)
+    {
+        blockWidth = 4;
+        blockHeight = 4;
+
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            blockWidth = 1;
+            blockHeight = 1;
+            blockBytes = 4;
+            return true;
+
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+            blockBytes = 8;
+            return true;
+
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+            blockBytes = 16;
+            return true;
+
+        default:
+            break;
+        }
+
+        // Every ASTC format uses 16 byte blocks
+        blockBytes = 16;
+        switch (format)
+        {
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            return true;
+        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
+            blockWidth = 5; blockHeight = 4; return true;
+        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+            blockWidth = 5; blockHeight = 5; return true;
+        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
+            blockWidth = 6; blockHeight = 5; return true;
+        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+            blockWidth = 6; blockHeight = 6; return true;
+        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
+            blockWidth = 8; blockHeight = 5; return true;
+        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
+            blockWidth = 8; blockHeight = 6; return true;
+        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+            blockWidth = 8; blockHeight = 8; return true;
+        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
+            blockWidth = 10; blockHeight = 5; return true;
+        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
+            blockWidth = 10; blockHeight = 6; return true;
+        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
+            blockWidth = 10; blockHeight = 8; return true;
+        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
+            blockWidth = 10; blockHeight = 10; return true;
+        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
+            blockWidth = 12; blockHeight = 10; return true;
+        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
+            blockWidth = 12; blockHeight = 12; return true;
+        default:
+            return false;
+        }
+    }
+
+    void TextureLoader::decodeColourBlock(const uint8_t* block, uint8_t* out, bool isBC1,
+            bool allowAlpha)
+    {
+        uint16_t c0 = block[0] | block[1] << 8;
+        uint16_t c1 = block[2] | block[3] << 8;
+
+        uint8_t colours[4][4];
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            uint16_t c = i == 0 ? c0 : c1;
+            uint8_t r = (c >> 11) & 0x1F;
+            uint8_t g = (c >> 5) & 0x3F;
+            uint8_t b = c & 0x1F;
+
+            colours[i][0] = (r << 3) | (r >> 2);
+            colours[i][1] = (g << 2) | (g >> 4);
+            colours[i][2] = (b << 3) | (b >> 2);
+            colours[i][3] = 255;
+        }
+
+        // BC1 switches to three colours plus black when c0 <= c1, the black
+        // is transparent for formats with alpha
+        bool fourColours = c0 > c1 || !isBC1;
+        for (uint32_t channel = 0; channel < 3; channel++)
+        {
+            if (fourColours)
+            {
+                colours[2][channel] = (2 * colours[0][channel] + colours[1][channel]) / 3;
+                colours[3][channel] = (colours[0][channel] + 2 * colours[1][channel]) / 3;
+            }
+            else
+            {
+                colours[2][channel] = (colours[0][channel] + colours[1][channel]) / 2;
+                colours[3][channel] = 0;
+            }
+        }
+        colours[2][3] = 255;
+        colours[3][3] = (fourColours || !allowAlpha) ? 255 : 0;
+
+        uint32_t indices = block[4] | block[5] << 8 | block[6] << 16 |
+            static_cast<uint32_t>(block[7]) << 24;
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            uint32_t index = (indices >> (i * 2)) & 0x3;
+            std::memcpy(out + i * 4, colours[index], 3);
+            out[i * 4 + 3] = std::min(out[i * 4 + 3], colours[index][3]);
+        }
+    }
+
+    void TextureLoader::decodeAlphaBlock(const uint8_t* block, uint8_t* out, uint32_t channel)
+    {
+        uint8_t values[8];
+        values[0] = block[0];
+        values[1] = block[1];
+
+        if (values[0] > values[1])
+        {
+            for (uint32_t i = 1; i < 7; i++)
+                values[i + 1] = ((7 - i) * values[0] + i * values[1]) / 7;
+        }
+        else
+        {
+            for (uint32_t i = 1; i < 5; i++)
+                values[i + 1] = ((5 - i) * values[0] + i * values[1]) / 5;
+            values[6] = 0;
+            values[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (uint32_t i = 0; i < 6; i++)
+            indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+
+        for (uint32_t i = 0; i < 16; i++)
+            out[i * 4 + channel] = values[(indices >> (i * 3)) & 0x7];
+    }
+
+    void TextureLoader::decodeSignedAlphaBlock(const uint8_t* block, uint8_t* out,
+            uint32_t channel)
+    {
+        // -128 decodes the same as -127
+        int32_t values[8];
+        values[0] = std::max<int32_t>(static_cast<int8_t>(block[0]), -127);
+        values[1] = std::max<int32_t>(static_cast<int8_t>(block[1]), -127);
+
+        if (values[0] > values[1])
+        {
+            for (int32_t i = 1; i < 7; i++)
+                values[i + 1] = ((7 - i) * values[0] + i * values[1]) / 7;
+        }
+        else
+        {
+            for (int32_t i = 1; i < 5; i++)
+                values[i + 1] = ((5 - i) * values[0] + i * values[1]) / 5;
+            values[6] = -127;
+            values[7] = 127;
+        }
+
+        uint64_t indices = 0;
+        for (uint32_t i = 0; i < 6; i++)
+            indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+
+        for (uint32_t i = 0; i < 16; i++)
+            out[i * 4 + channel] = static_cast<uint8_t>(static_cast<int8_t>(
+                        values[(indices >> (i * 3)) & 0x7]));
+    }
+
+    void TextureLoader::decodeExplicitAlphaBlock(const uint8_t* block, uint8_t* out)
+    {
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            uint8_t alpha = (block[i / 2] >> ((i % 2) * 4)) & 0xF;
+            out[i * 4 + 3] = (alpha << 4) | alpha;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    struct TextureLevel
+    {
+        size_t offset;
+        size_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct TextureData
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent3D extent{};
+
+        // Level 0 is the full size image, every level is tightly packed
+        std::vector<TextureLevel> levels;
+        std::vector<uint8_t> data;
+    };
+
+    // Reads KTX2 and DDS containers holding 2D textures. Supercompressed KTX2
+    // files (Basis Universal, Zstandard) are not supported
+    class EOS_API TextureLoader
+    {
+    public:
+        static bool isContainerFile(const char* file);
+
+        static bool load(const char* file, TextureData& textureData);
+
+        static bool isFormatSupported(VkFormat format);
+        static bool isCompressedFormat(VkFormat format);
+
+        // Decodes BC1 - BC5 data into RGBA8 for devices without BC support,
+        // BC4 and BC5 SNORM into R8G8B8A8_SNORM. Returns false for any other
+        // format or when a level is smaller than its size requires
+        static bool decodeToRGBA(TextureData& textureData);
+
+    private:
+        static bool loadKTX2(const std::vector<uint8_t>& file, TextureData& textureData);
+        static bool loadDDS(const std::vector<uint8_t>& file, TextureData& textureData);
+
+        static bool getBlockInfo(VkFormat format, uint32_t& blockWidth, uint32_t& blockHeight,
+                uint32_t& blockBytes);
+
+        static void decodeColourBlock(const uint8_t* block, uint8_t* out, bool isBC1,
+                bool allowAlpha);
+        static void decodeAlphaBlock(const uint8_t* block, uint8_t* out, uint32_t channel);
+        static void decodeSignedAlphaBlock(const uint8_t* block, uint8_t* out, uint32_t channel);
+        static void decodeExplicitAlphaBlock(const uint8_t* block, uint8_t* out);
+    };
+}
@@ -0,0 +1,549 @@
+#include "TextureStreamer.hpp"
+
+#include "Eos/Engine/GlobalData.hpp"
+#include "Eos/Engine/Initializers.hpp"
+
+#include <algorithm>
+
+namespace Eos
+{
+    void TextureStreamer::init(Queue* queue, Texture2D* placeholder, uint32_t framesInFlight,
+            VkDeviceSize budget)
+    {
+        m_Queue = queue;
+        m_Placeholder = placeholder;
+        m_FramesInFlight = framesInFlight;
+        m_Budget = budget;
+
+        VkCommandPoolCreateInfo poolInfo = Init::commandPoolCreateInfo(m_Queue->family,
+                VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        EOS_VK_CHECK(vkCreateCommandPool(GlobalData::getDevice(), &poolInfo, nullptr,
+                    &m_CommandPool));
+    }
+
+    void TextureStreamer::cleanup()
+    {
+        completeUploads(true);
+
+        VkDevice device = GlobalData::getDevice();
+
+        for (UploadBatch& batch : m_FreeBatches)
+            vkDestroyFence(device, batch.fence, nullptr);
+        m_FreeBatches.clear();
+
+        vkDestroyCommandPool(device, m_CommandPool, nullptr);
+
+        m_Retired.clear();
+
+        for (StreamedTextureHandle& texture : m_Textures)
+            texture->m_Texture.reset();
+        m_Textures.clear();
+
+        m_ResidentBytes = 0;
+    }
+
+    StreamedTextureHandle TextureStreamer::load(const char* file)
+    {
+        StreamedTextureHandle texture = std::make_shared<StreamedTexture>();
+        texture->m_Placeholder = m_Placeholder;
+        TextureData& textureData = texture->m_Data;
+
+        if (TextureLoader::isContainerFile(file))
+        {
+            if (!TextureLoader::load(file, textureData))
+                return nullptr;
+
+            if (!TextureLoader::isFormatSupported(textureData.format))
+            {
+                if (!TextureLoader::decodeToRGBA(textureData))
+                {
+                    EOS_CORE_LOG_ERROR("Texture {} uses a format not supported by this device",
+                            file);
+                    return nullptr;
+                }
+            }
+        }
+        else
+        {
+            int texWidth;
+            int texHeight;
+            int texChannels;
+
+            stbi_uc* pixels = stbi_load(file, &texWidth, &texHeight, &texChannels,
+                    STBI_rgb_alpha);
+
+            if (!pixels)
+            {
+                EOS_CORE_LOG_ERROR("Failed to load Texture {}", file);
+                return nullptr;
+            }
+
+            size_t size = static_cast<size_t>(texWidth) * texHeight * 4;
+
+            textureData.format = VK_FORMAT_R8G8B8A8_SRGB;
+            textureData.extent = { static_cast<uint32_t>(texWidth),
+                static_cast<uint32_t>(texHeight), 1 };
+            textureData.levels = { { 0, size, textureData.extent.width,
+                textureData.extent.height } };
+            textureData.data.assign(pixels, pixels + size);
+
+            stbi_image_free(pixels);
+        }
+
+        // Compressed files are streamed only when they ship their own mips
+        if (textureData.levels.size() == 1 && !TextureLoader::isCompressedFormat(textureData.format))
+            generateMipChain(textureData);
+
+        uint32_t minimumMip = textureData.levels.size() - 1;
+        for (uint32_t i = 0; i < textureData.levels.size(); i++)
+        {
+            const TextureLevel& level = textureData.levels[i];
+            if (std::max(level.width, level.height) <= s_MinimumResidentSize)
+            {
+                minimumMip = i;
+                break;
+            }
+        }
+
+        texture->m_MinimumMip = minimumMip;
+        texture->m_ResidentMip = minimumMip;
+        texture->m_DesiredMip = minimumMip;
+        texture->m_TargetMip = minimumMip;
+        texture->m_LastUsedFrame = m_Frame;
+
+        std::vector<StreamedTextureHandle> changed = { texture };
+        applyResidency(changed);
+
+        m_Textures.push_back(texture);
+        return texture;
+    }
+
+    void TextureStreamer::update(uint64_t frame)
+    {
+        m_Frame = frame;
+
+        completeUploads(false);
+
+        // Images are only destroyed once no frame in flight can reference them
+        m_Retired.erase(std::remove_if(m_Retired.begin(), m_Retired.end(),
+                    [&](const RetiredTexture& retired) {
+                        return retired.frame + m_FramesInFlight <= m_Frame;
+                    }), m_Retired.end());
+
+        for (auto it = m_Textures.begin(); it != m_Textures.end();)
+        {
+            StreamedTexture& texture = **it;
+
+            // Only the streamer holds the handle, the texture is no longer used.
+            // Batches hold one as well until they have finished
+            if (it->use_count() == 1)
+            {
+                m_ResidentBytes -= getResidentSize(texture, texture.m_ResidentMip);
+                m_Retired.push_back({ std::move(texture.m_Texture), m_Frame });
+
+                it = m_Textures.erase(it);
+                continue;
+            }
+
+            if (texture.m_RequestedMip != UINT32_MAX)
+            {
+                texture.m_DesiredMip = std::min(texture.m_RequestedMip, texture.m_MinimumMip);
+                texture.m_RequestedMip = UINT32_MAX;
+                texture.m_LastUsedFrame = m_Frame;
+            }
+            else if (m_Frame - texture.m_LastUsedFrame > s_IdleFrames)
+            {
+                texture.m_DesiredMip = texture.m_MinimumMip;
+            }
+
+            if (!texture.m_Uploading)
+                texture.m_TargetMip = texture.m_ResidentMip;
+            it++;
+        }
+
+        VkDeviceSize budget = getAvailableBudget();
+        VkDeviceSize projectedBytes = m_ResidentBytes;
+
+        // Levels nobody asked for go first, recently used levels only when
+        // that is not enough
+        while (projectedBytes > budget && evictLeastRecentlyUsed(projectedBytes, false));
+        while (projectedBytes > budget && evictLeastRecentlyUsed(projectedBytes, true));
+
+        std::vector<StreamedTexture*> candidates;
+        for (StreamedTextureHandle& texture : m_Textures)
+        {
+            if (!texture->m_Uploading && texture->m_DesiredMip < texture->m_TargetMip)
+                candidates.push_back(texture.get());
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+                [](const StreamedTexture* a, const StreamedTexture* b) {
+                    if (a->m_LastUsedFrame != b->m_LastUsedFrame)
+                        return a->m_LastUsedFrame > b->m_LastUsedFrame;
+                    return a->m_TargetMip - a->m_DesiredMip > b->m_TargetMip - b->m_DesiredMip;
+                });
+
+        // One level per texture per frame keeps upload stalls short
+        uint32_t uploads = 0;
+        for (StreamedTexture* texture : candidates)
+        {
+            if (uploads >= s_MaxUploadsPerFrame)
+                break;
+
+            VkDeviceSize cost = texture->m_Data.levels[texture->m_TargetMip - 1].size;
+
+            while (projectedBytes + cost > budget &&
+                    evictLeastRecentlyUsed(projectedBytes, false));
+
+            if (projectedBytes + cost > budget)
+                break;
+
+            texture->m_TargetMip--;
+            projectedBytes += cost;
+            uploads++;
+        }
+
+        std::vector<StreamedTextureHandle> changed;
+        for (StreamedTextureHandle& texture : m_Textures)
+        {
+            if (!texture->m_Uploading && texture->m_TargetMip != texture->m_ResidentMip)
+                changed.push_back(texture);
+        }
+
+        applyResidency(changed);
+    }
+
+    TextureStreamer::Statistics TextureStreamer::getStatistics()
+    {
+        m_Statistics.residentBytes = m_ResidentBytes;
+        m_Statistics.textures = m_Textures.size();
+        return m_Statistics;
+    }
+
+    VkDeviceSize TextureStreamer::getAvailableBudget()
+    {
+        VkDeviceSize budget = m_Budget != 0 ? m_Budget : UINT64_MAX;
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties;
+        vmaGetMemoryProperties(GlobalData::getAllocator(), &memoryProperties);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(GlobalData::getAllocator(), budgets);
+
+        // Textures are placed in the largest device local heap
+        int32_t heapIndex = -1;
+        for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++)
+        {
+            const VkMemoryHeap& heap = memoryProperties->memoryHeaps[i];
+            if (!(heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+                continue;
+
+            if (heapIndex == -1 || heap.size > memoryProperties->memoryHeaps[heapIndex].size)
+                heapIndex = i;
+        }
+
+        if (heapIndex != -1)
+        {
+            const VmaBudget& heapBudget = budgets[heapIndex];
+
+            // Memory used by everything else in the application is not ours to take
+            VkDeviceSize limit = static_cast<VkDeviceSize>(heapBudget.budget * s_HeapBudgetFraction);
+            VkDeviceSize otherUsage = heapBudget.usage > m_ResidentBytes ?
+                heapBudget.usage - m_ResidentBytes : 0;
+            VkDeviceSize available = limit > otherUsage ? limit - otherUsage : 0;
+
+            budget = std::min(budget, available);
+        }
+
+        m_Statistics.budget = budget;
+        return budget;
+    }
+
+    VkDeviceSize TextureStreamer::getResidentSize(const StreamedTexture& texture,
+            uint32_t baseMip)
+    {
+        VkDeviceSize size = 0;
+        for (uint32_t i = baseMip; i < texture.m_Data.levels.size(); i++)
+            size += texture.m_Data.levels[i].size;
+
+        return size;
+    }
+
+    bool TextureStreamer::evictLeastRecentlyUsed(VkDeviceSize& projectedBytes, bool allowUsed)
+    {
+        StreamedTexture* victim = nullptr;
+
+        for (StreamedTextureHandle& handle : m_Textures)
+        {
+            StreamedTexture* texture = handle.get();
+            if (texture->m_Uploading || texture->m_TargetMip >= texture->m_MinimumMip)
+                continue;
+
+            if (!allowUsed && texture->m_TargetMip >= texture->m_DesiredMip)
+                continue;
+
+            if (!victim || texture->m_LastUsedFrame < victim->m_LastUsedFrame ||
+                    (texture->m_LastUsedFrame == victim->m_LastUsedFrame &&
+                     texture->m_TargetMip < victim->m_TargetMip))
+                victim = texture;
+        }
+
+        if (!victim)
+            return false;
+
+        projectedBytes -= victim->m_Data.levels[victim->m_TargetMip].size;
+        victim->m_TargetMip++;
+
+        m_Statistics.evictions++;
+        return true;
+    }
+
+    void TextureStreamer::applyResidency(std::vector<StreamedTextureHandle>& changed)
+    {
+        if (changed.empty())
+            return;
+
+        // Levels that are already resident are copied from the current image
+        // on the GPU, only newly requested levels come from the CPU copy
+        size_t stagingSize = 0;
+        for (StreamedTextureHandle& texture : changed)
+        {
+            uint32_t uploadEnd = texture->m_Texture ?
+                std::min(texture->m_ResidentMip, texture->getMipLevels()) :
+                texture->getMipLevels();
+
+            for (uint32_t level = texture->m_TargetMip; level < uploadEnd; level++)
+                stagingSize += texture->m_Data.levels[level].size;
+        }
+
+        UploadBatch batch = getBatch();
+
+        void* data = nullptr;
+        if (stagingSize > 0)
+        {
+            batch.stagingBuffer.create(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    VMA_MEMORY_USAGE_CPU_ONLY);
+            vmaMapMemory(GlobalData::getAllocator(), batch.stagingBuffer.allocation, &data);
+        }
+
+        VkCommandBufferBeginInfo beginInfo = Init::commandBufferBeginInfo(
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        EOS_VK_CHECK(vkBeginCommandBuffer(batch.commandBuffer, &beginInfo));
+
+        size_t offset = 0;
+        for (StreamedTextureHandle& streamed : changed)
+        {
+            const TextureData& textureData = streamed->m_Data;
+            uint32_t baseMip = streamed->m_TargetMip;
+            uint32_t levelCount = textureData.levels.size() - baseMip;
+
+            const TextureLevel& baseLevel = textureData.levels[baseMip];
+
+            std::unique_ptr<Texture2D> texture = std::make_unique<Texture2D>();
+            texture->createImage(textureData.format,
+                    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                    VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                    { baseLevel.width, baseLevel.height, 1 }, VMA_MEMORY_USAGE_GPU_ONLY, 0,
+                    levelCount);
+            texture->createImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+            texture->createSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+
+            texture->transition(batch.commandBuffer, Access::TransferDst);
+
+            uint32_t copyStart = textureData.levels.size();
+            if (streamed->m_Texture)
+                copyStart = std::max(baseMip, streamed->m_ResidentMip);
+
+            std::vector<VkBufferImageCopy> regions;
+            for (uint32_t level = baseMip; level < copyStart; level++)
+            {
+                const TextureLevel& sourceLevel = textureData.levels[level];
+
+                memcpy(static_cast<uint8_t*>(data) + offset,
+                        textureData.data.data() + sourceLevel.offset, sourceLevel.size);
+
+                VkBufferImageCopy copyRegion{};
+                copyRegion.bufferOffset = offset;
+                copyRegion.bufferRowLength = 0;
+                copyRegion.bufferImageHeight = 0;
+                copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                copyRegion.imageSubresource.mipLevel = level - baseMip;
+                copyRegion.imageSubresource.baseArrayLayer = 0;
+                copyRegion.imageSubresource.layerCount = 1;
+                copyRegion.imageExtent = { sourceLevel.width, sourceLevel.height, 1 };
+
+                regions.push_back(copyRegion);
+                offset += sourceLevel.size;
+            }
+
+            if (!regions.empty())
+            {
+                vkCmdCopyBufferToImage(batch.commandBuffer, batch.stagingBuffer.buffer,
+                        texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(),
+                        regions.data());
+            }
+
+            if (copyStart < textureData.levels.size())
+            {
+                Texture2D& current = *streamed->m_Texture;
+
+                std::vector<VkImageCopy> copies;
+                for (uint32_t level = copyStart; level < textureData.levels.size(); level++)
+                {
+                    const TextureLevel& sourceLevel = textureData.levels[level];
+
+                    VkImageCopy copy{};
+                    copy.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT,
+                        level - streamed->m_ResidentMip, 0, 1 };
+                    copy.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - baseMip, 0, 1 };
+                    copy.extent = { sourceLevel.width, sourceLevel.height, 1 };
+
+                    copies.push_back(copy);
+                }
+
+                // The current image stays bound until the batch is done, so it
+                // is returned to the shader readable layout straight after
+                current.transition(batch.commandBuffer, Access::TransferSrc);
+                vkCmdCopyImage(batch.commandBuffer,
+                        current.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        copies.size(), copies.data());
+                current.transition(batch.commandBuffer, Access::FragmentShaderRead);
+            }
+
+            texture->transition(batch.commandBuffer, Access::FragmentShaderRead);
+
+            // The memory is allocated now, so the budget counts the new size
+            // straight away. The old image stays in use until the batch is done
+            if (streamed->m_Texture)
+                m_ResidentBytes -= getResidentSize(*streamed, streamed->m_ResidentMip);
+            m_ResidentBytes += getResidentSize(*streamed, streamed->m_TargetMip);
+
+            if (streamed->m_TargetMip < streamed->m_ResidentMip)
+                m_Statistics.uploads++;
+
+            streamed->m_Uploading = true;
+            batch.textures.push_back({ streamed, std::move(texture) });
+        }
+
+        if (stagingSize > 0)
+            vmaUnmapMemory(GlobalData::getAllocator(), batch.stagingBuffer.allocation);
+
+        EOS_VK_CHECK(vkEndCommandBuffer(batch.commandBuffer));
+
+        VkSubmitInfo submit = Init::submitInfo(&batch.commandBuffer);
+        EOS_VK_CHECK(m_Queue->submit(1, &submit, batch.fence));
+
+        m_InFlight.push_back(std::move(batch));
+    }
+
+    void TextureStreamer::completeUploads(bool wait)
+    {
+        VkDevice device = GlobalData::getDevice();
+
+        for (auto it = m_InFlight.begin(); it != m_InFlight.end();)
+        {
+            if (wait)
+                vkWaitForFences(device, 1, &it->fence, true, UINT64_MAX);
+            else if (vkGetFenceStatus(device, it->fence) != VK_SUCCESS)
+            {
+                it++;
+                continue;
+            }
+
+            for (PendingTexture& pending : it->textures)
+            {
+                StreamedTexture& texture = *pending.texture;
+
+                if (texture.m_Texture)
+                    m_Retired.push_back({ std::move(texture.m_Texture), m_Frame });
+
+                texture.m_Texture = std::move(pending.image);
+                texture.m_ResidentMip = texture.m_TargetMip;
+                texture.m_Uploading = false;
+            }
+
+            if (it->stagingBuffer.size > 0)
+                it->stagingBuffer.destroy();
+            it->stagingBuffer.size = 0;
+            it->textures.clear();
+
+            m_FreeBatches.push_back(std::move(*it));
+            it = m_InFlight.erase(it);
+        }
+    }
+
+    TextureStreamer::UploadBatch TextureStreamer::getBatch()
+    {
+        if (!m_FreeBatches.empty())
+        {
+            UploadBatch batch = std::move(m_FreeBatches.back());
+            m_FreeBatches.pop_back();
+
+            EOS_VK_CHECK(vkResetFences(GlobalData::getDevice(), 1, &batch.fence));
+            EOS_VK_CHECK(vkResetCommandBuffer(batch.commandBuffer, 0));
+
+            return batch;
+        }
+
+        UploadBatch batch;
+
+        VkCommandBufferAllocateInfo allocInfo = Init::commandBufferAllocateInfo(m_CommandPool, 1);
+        EOS_VK_CHECK(vkAllocateCommandBuffers(GlobalData::getDevice(), &allocInfo,
+                    &batch.commandBuffer));
+
+        VkFenceCreateInfo fenceInfo = Init::fenceCreateInfo();
+        EOS_VK_CHECK(vkCreateFence(GlobalData::getDevice(), &fenceInfo, nullptr, &batch.fence));
+
+        return batch;
+    }
+
+    void TextureStreamer::generateMipChain(TextureData& textureData)
+    {
+        // Box filters RGBA8 level 0 down to 1x1
+        uint32_t width = textureData.extent.width;
+        uint32_t height = textureData.extent.height;
+
+        while (width > 1 || height > 1)
+        {
+            TextureLevel source = textureData.levels.back();
+
+            TextureLevel level;
+            level.width = std::max(width / 2, 1u);
+            level.height = std::max(height / 2, 1u);
+            level.offset = textureData.data.size();
+            level.size = static_cast<size_t>(level.width) * level.height * 4;
+
+            textureData.data.resize(textureData.data.size() + level.size);
+
+            const uint8_t* in = textureData.data.data() + source.offset;
+            uint8_t* out = textureData.data.data() + level.offset;
+
+            for (uint32_t y = 0; y < level.height; y++)
+            {
+                for (uint32_t x = 0; x < level.width; x++)
+                {
+                    uint32_t x0 = std::min(x * 2, width - 1);
+                    uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                    uint32_t y0 = std::min(y * 2, height - 1);
+                    uint32_t y1 = std::min(y * 2 + 1, height - 1);
+
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        uint32_t sum = in[(y0 * width + x0) * 4 + c] +
+                            in[(y0 * width + x1) * 4 + c] +
+                            in[(y1 * width + x0) * 4 + c] +
+                            in[(y1 * width + x1) * 4 + c];
+
+                        out[(y * level.width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            }
+
+            textureData.levels.push_back(level);
+
+            width = level.width;
+            height = level.height;
+        }
+    }
+}
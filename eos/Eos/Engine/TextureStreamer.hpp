@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Engine/Buffer.hpp"
+#include "Eos/Engine/Texture.hpp"
+#include "Eos/Engine/TextureLoader.hpp"
+#include "Eos/Engine/Types.hpp"
+
+#include <deque>
+
+#include <vulkan/vulkan.h>
+
+namespace Eos
+{
+    class EOS_API StreamedTexture
+    {
+    public:
+        // The image is recreated whenever residency changes, so descriptors
+        // should be written from get() every frame. Returns the placeholder
+        // until the first levels have been uploaded
+        Texture2D& get() { return m_Texture ? *m_Texture : *m_Placeholder; }
+        bool isReady() const { return m_Texture != nullptr; }
+
+        // Asks for mip level mip to be resident. Calling this marks the
+        // texture as used this frame, the most detailed request wins
+        void requestMip(uint32_t mip) { m_RequestedMip = std::min(m_RequestedMip, mip); }
+
+        uint32_t getResidentMip() const { return m_ResidentMip; }
+        uint32_t getMipLevels() const { return m_Data.levels.size(); }
+    private:
+        friend class TextureStreamer;
+
+        std::unique_ptr<Texture2D> m_Texture;
+        Texture2D* m_Placeholder = nullptr;
+
+        // Every level is kept on the CPU so that residency can change without
+        // reading the file again
+        TextureData m_Data;
+
+        uint32_t m_ResidentMip = 0;
+        uint32_t m_MinimumMip = 0;
+        uint32_t m_DesiredMip = 0;
+        uint32_t m_RequestedMip = UINT32_MAX;
+        uint32_t m_TargetMip = 0;
+
+        // Residency is not changed again until the upload of m_TargetMip is done
+        bool m_Uploading = false;
+
+        uint64_t m_LastUsedFrame = 0;
+    };
+
+    using StreamedTextureHandle = std::shared_ptr<StreamedTexture>;
+
+    // Keeps streamed textures inside a memory budget. Only the small tail of
+    // each mip chain is loaded up front, more detailed levels are uploaded as
+    // they are requested and the least recently used levels are dropped when
+    // the budget is exceeded. Uploads are submitted in batches without
+    // waiting, the new image replaces the old one once its batch has finished
+    class EOS_API TextureStreamer
+    {
+    public:
+        struct Statistics
+        {
+            VkDeviceSize residentBytes = 0;
+            VkDeviceSize budget = 0;
+            uint32_t uploads = 0;
+            uint32_t evictions = 0;
+            size_t textures = 0;
+        };
+
+    public:
+        void init(Queue* queue, Texture2D* placeholder, uint32_t framesInFlight,
+                VkDeviceSize budget = 0);
+        void cleanup();
+
+        StreamedTextureHandle load(const char* file);
+
+        // A budget of 0 only uses the device heap budgets reported by VMA
+        void setBudget(VkDeviceSize budget) { m_Budget = budget; }
+
+        void update(uint64_t frame);
+
+        Statistics getStatistics();
+    private:
+        struct RetiredTexture
+        {
+            std::unique_ptr<Texture2D> texture;
+            uint64_t frame;
+        };
+
+        struct PendingTexture
+        {
+            StreamedTextureHandle texture;
+            std::unique_ptr<Texture2D> image;
+        };
+
+        struct UploadBatch
+        {
+            VkCommandBuffer commandBuffer;
+            VkFence fence;
+
+            Buffer stagingBuffer;
+            std::vector<PendingTexture> textures;
+        };
+
+        // Levels at or below this size are always resident
+        static const uint32_t s_MinimumResidentSize = 64;
+        // Frames without a request before a texture only wants its tail
+        static const uint64_t s_IdleFrames = 120;
+        static const uint32_t s_MaxUploadsPerFrame = 4;
+        // Fraction of the device heap budget the streamer may grow into
+        static constexpr float s_HeapBudgetFraction = 0.9f;
+
+        std::vector<StreamedTextureHandle> m_Textures;
+        std::vector<RetiredTexture> m_Retired;
+
+        // Buffer has no move constructor, so a vector would try to copy the
+        // batches when it grows
+        std::deque<UploadBatch> m_InFlight;
+        std::deque<UploadBatch> m_FreeBatches;
+
+        VkDeviceSize m_Budget = 0;
+        VkDeviceSize m_ResidentBytes = 0;
+
+        uint64_t m_Frame = 0;
+        uint32_t m_FramesInFlight = 1;
+
+        Statistics m_Statistics;
+
+        Texture2D* m_Placeholder;
+
+        Queue* m_Queue;
+        VkCommandPool m_CommandPool;
+    private:
+        VkDeviceSize getAvailableBudget();
+
+        VkDeviceSize getResidentSize(const StreamedTexture& texture, uint32_t baseMip);
+
+        bool evictLeastRecentlyUsed(VkDeviceSize& projectedBytes, bool allowUsed);
+
+        void applyResidency(std::vector<StreamedTextureHandle>& changed);
+
+        // Swaps in the images of finished batches
+        void completeUploads(bool wait);
+        UploadBatch getBatch();
+
+        static void generateMipChain(TextureData& textureData);
+    };
+}
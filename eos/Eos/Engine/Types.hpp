@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <optional>
+#include <mutex>
 
 #include <vulkan/vulkan.h>
 #include "vk_mem_alloc.h"
@@ -14,6 +15,17 @@ namespace Eos
     {
         VkQueue queue;
         uint32_t family;
+
+        // Shared between copies, so queues that fall back to another one
+        // also share its lock
+        std::shared_ptr<std::mutex> mutex = std::make_shared<std::mutex>();
+
+        // Submissions to a queue have to be externally synchronised
+        VkResult submit(uint32_t count, const VkSubmitInfo* submits, VkFence fence) const
+        {
+            std::lock_guard<std::mutex> lock(*mutex);
+            return vkQueueSubmit(queue, count, submits, fence);
+        }
     };
 
     struct Swapchain
@@ -16,6 +16,8 @@
 #include "Core/Logger.hpp"
 #include "Core/DeletionQueue.hpp"
 #include "Core/Timer.hpp"
+#include "Core/Hash.hpp"
+#include "Core/JobSystem.hpp"
 
 // Core / Cameras
 #include "Core/Cameras/Orthographic.hpp"
@@ -23,26 +25,45 @@
 
 
 // Engine
+#include "Engine/AsyncCompute.hpp"
+#include "Engine/AsyncTextureLoader.hpp"
+#include "Engine/BarrierBatcher.hpp"
 #include "Engine/Buffer.hpp"
+#include "Engine/CommandPools.hpp"
+#include "Engine/ComputeJobs.hpp"
 #include "Engine/ComputeShader.hpp"
+#include "Engine/Defragmenter.hpp"
 #include "Engine/Engine.hpp"
 #include "Engine/GlobalData.hpp"
+#include "Engine/GpuPrimitives.hpp"
+#include "Engine/ImageState.hpp"
 #include "Engine/Initializers.hpp"
+#include "Engine/MemoryStats.hpp"
 #include "Engine/Mesh.hpp"
+#include "Engine/ReadbackRing.hpp"
 #include "Engine/RenderPassBuilder.hpp"
+#include "Engine/SamplerCache.hpp"
 #include "Engine/Shader.hpp"
+#include "Engine/SyncPools.hpp"
 #include "Engine/Texture.hpp"
+#include "Engine/TextureAtlas.hpp"
+#include "Engine/TextureLoader.hpp"
+#include "Engine/TextureStreamer.hpp"
 #include "Engine/Types.hpp"
 
 // Engine / Descriptor Sets
 #include "Engine/DescriptorSets/DescriptorAllocator.hpp"
 #include "Engine/DescriptorSets/DescriptorLayoutCache.hpp"
+#include "Engine/DescriptorSets/DescriptorSetCache.hpp"
 #include "Engine/DescriptorSets/DescriptorBuilder.hpp"
+#include "Engine/DescriptorSets/FrameDescriptorAllocator.hpp"
 
 // Engine / Pipelines
 #include "Engine/Pipelines/ComputePipelineBuilder.hpp"
 #include "Engine/Pipelines/PipelineBuilder.hpp"
 #include "Engine/Pipelines/PipelineCreationInfo.hpp"
+#include "Engine/Pipelines/PipelineLayoutCache.hpp"
+#include "Engine/Pipelines/SpecializationConstants.hpp"
 
 // Engine / Submits
 #include "Engine/Submits/TransferSubmit.hpp"
@@ -53,6 +74,8 @@
 #include "Events/EventDispatcher.hpp"
 #include "Events/EventCodes.hpp"
 #include "Events/Events.hpp"
+#include "Events/EventQueue.hpp"
+#include "Events/InputState.hpp"
 
 
 // Imgui
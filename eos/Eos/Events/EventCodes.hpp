@@ -11,6 +11,8 @@ namespace Eos::Events
         SCROLL,
 
         WINDOW_RESIZE,
+
+        TYPE_COUNT
     };
 
     enum class Action
@@ -4,49 +4,128 @@
 
 #include "Eos/Events/Events.hpp"
 
-#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace Eos::Events
 {
     template <typename T>
-    concept EventTemplate = std::is_base_of<Event, T>();
+    concept EventTemplate = std::is_base_of_v<Event, T>;
 
-    class EOS_API EventDispatcher
+    // A function pointer and the data handed to it, no allocation. Member
+    // functions are bound through a stub instantiated for that function
+    template <EventTemplate T>
+    class EventDelegate
     {
-        typedef bool(*EventFunction)(const Event*);
-        typedef std::pair<EventFunction, void*> FunctionPair;
+    public:
+        using Function = bool(*)(const T& event, void* data);
 
     public:
-        template <EventTemplate T>
-        void addCallback(bool(*function)(const T*), void* dataPointer = nullptr)
+        EventDelegate(Function function, void* data = nullptr)
+            : m_Function(function), m_Data(data) {}
+
+        template <auto Method, typename C>
+        static EventDelegate bind(C* instance)
         {
-            EventFunction castFunction =
-                reinterpret_cast<EventFunction>(function);
+            return EventDelegate(&memberStub<Method, C>, instance);
+        }
+
+        bool operator()(const T& event) const { return m_Function(event, m_Data); }
 
-            s_FunctionCallbacks[T::eventType].push_back(
-                    std::make_pair(castFunction, dataPointer));
+        void* getData() const { return m_Data; }
+    private:
+        Function m_Function;
+        void* m_Data;
+    private:
+        template <auto Method, typename C>
+        static bool memberStub(const T& event, void* instance)
+        {
+            return (static_cast<C*>(instance)->*Method)(event);
         }
+    };
 
+    class EOS_API EventDispatcher
+    {
+    public:
         template <EventTemplate T>
-        void dispatchEvent(const T& event)
+        void addCallback(bool(*function)(const T&, void*), void* data = nullptr)
         {
-            const auto& functions = s_FunctionCallbacks[event.eventType];
+            getDelegates<T>().emplace_back(function, data);
+        }
 
-            for (FunctionPair func : functions)
-            {
-                bool (*castFunc)(const T*) =
-                    reinterpret_cast<bool(*)(const T*)>(func.first);
+        // addCallback<&Class::function>(this), for bool Class::function(const T&)
+        template <auto Method, typename C>
+        void addCallback(C* instance)
+        {
+            using T = typename MethodEvent<decltype(Method)>::Type;
 
-                T modifiedEvent = event;
-                modifiedEvent.dataPointer = func.second;
+            getDelegates<T>().push_back(EventDelegate<T>::template bind<Method, C>(instance));
+        }
 
-                if (castFunc(&modifiedEvent))
+        // Removes every callback registered with data or instance
+        void removeCallbacks(void* data)
+        {
+            std::apply([data](auto&... delegates) {
+                (std::erase_if(delegates, [data](const auto& delegate) {
+                    return delegate.getData() == data;
+                }), ...);
+            }, m_Delegates);
+        }
+
+        // Stops at the first callback returning true
+        template <EventTemplate T>
+        void dispatchEvent(const T& event) const
+        {
+            for (const EventDelegate<T>& delegate : getDelegates<T>())
+            {
+                if (delegate(event))
                 {
                     break;
                 }
             }
         }
     private:
-        std::unordered_map<Type, std::vector<FunctionPair>> s_FunctionCallbacks;
+        template <typename Tuple>
+        struct DelegateTable;
+
+        template <typename... Ts>
+        struct DelegateTable<std::tuple<Ts...>>
+        {
+            using Type = std::tuple<std::vector<EventDelegate<Ts>>...>;
+        };
+
+        template <typename M>
+        struct MethodEvent;
+
+        template <typename C, typename T>
+        struct MethodEvent<bool(C::*)(const T&)> { using Type = T; };
+
+        // One list per Type, indexed at compile time by the event's eventType
+        typename DelegateTable<EventTypes>::Type m_Delegates;
+    private:
+        template <EventTemplate T>
+        static constexpr size_t indexOf()
+        {
+            constexpr size_t index = static_cast<size_t>(T::eventType);
+
+            static_assert(index < static_cast<size_t>(Type::TYPE_COUNT));
+            static_assert(std::is_same_v<std::tuple_element_t<index, EventTypes>, T>,
+                    "EventTypes has to be in the order of Type");
+
+            return index;
+        }
+
+        template <EventTemplate T>
+        std::vector<EventDelegate<T>>& getDelegates()
+        {
+            return std::get<indexOf<T>()>(m_Delegates);
+        }
+
+        template <EventTemplate T>
+        const std::vector<EventDelegate<T>>& getDelegates() const
+        {
+            return std::get<indexOf<T>()>(m_Delegates);
+        }
     };
 }
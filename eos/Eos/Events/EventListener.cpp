@@ -4,6 +4,11 @@ namespace Eos::Events
 {
     std::vector<EventDispatcher*> EventListener::s_Dispatchers;
 
+    EventQueue EventListener::s_Queue;
+    std::vector<QueuedEvent> EventListener::s_Batch;
+
+    InputState EventListener::s_InputState;
+
     void EventListener::setupListener(std::shared_ptr<Window>& window)
     {
         glfwSetKeyCallback(window->getWindow(), glfwKeyCallback);
@@ -34,6 +39,32 @@ namespace Eos::Events
         }
     }
 
+    void EventListener::processEvents()
+    {
+        s_Batch.clear();
+        s_Queue.drain(s_Batch);
+
+        for (const QueuedEvent& queued : s_Batch)
+        {
+            std::visit([](const auto& event) {
+                if constexpr (requires { s_InputState.handleEvent(event); })
+                    s_InputState.handleEvent(event);
+            }, queued);
+        }
+
+        s_InputState.update();
+
+        for (const QueuedEvent& queued : s_Batch)
+        {
+            std::visit([](const auto& event) {
+                using T = std::decay_t<decltype(event)>;
+
+                if constexpr (!std::is_same_v<T, std::monostate>)
+                    dispatchEvent(event);
+            }, queued);
+        }
+    }
+
     void EventListener::glfwKeyCallback(GLFWwindow* window, int key, int scancode,
             int action, int mods)
     {
@@ -43,9 +74,10 @@ namespace Eos::Events
             static_cast<Mods>(mods)
         };
 
-        dispatchEvent(event);
+        if (!s_Queue.push(event))
+            EOS_CORE_LOG_WARN("Event queue is full, dropped Key Input Event");
 
-        EOS_CORE_LOG_TRACE("Dispatched Key Input Event");
+        EOS_CORE_LOG_TRACE("Queued Key Input Event");
     }
 
     void EventListener::glfwMouseButtonCallback(GLFWwindow* window, int button,
@@ -57,9 +89,10 @@ namespace Eos::Events
             static_cast<Mods>(mods)
         };
 
-        dispatchEvent(event);
+        if (!s_Queue.push(event))
+            EOS_CORE_LOG_WARN("Event queue is full, dropped Mouse Button Event");
 
-        EOS_CORE_LOG_TRACE("Dispatched Mouse Button Event");
+        EOS_CORE_LOG_TRACE("Queued Mouse Button Event");
     }
 
     void EventListener::glfwMouseMoveCallback(GLFWwindow* window, double x, double y)
@@ -69,9 +102,10 @@ namespace Eos::Events
             static_cast<float>(y)
         };
 
-        dispatchEvent(event);
+        if (!s_Queue.push(event))
+            EOS_CORE_LOG_WARN("Event queue is full, dropped Mouse Move Event");
 
-        EOS_CORE_LOG_TRACE("Dispatched Mouse Move Event");
+        EOS_CORE_LOG_TRACE("Queued Mouse Move Event");
     }
 
     void EventListener::glfwScrollCallback(GLFWwindow* window, double x, double y)
@@ -81,9 +115,10 @@ namespace Eos::Events
             static_cast<float>(y)
         };
 
-        dispatchEvent(event);
+        if (!s_Queue.push(event))
+            EOS_CORE_LOG_WARN("Event queue is full, dropped Scroll Event");
 
-        EOS_CORE_LOG_TRACE("Dispatched Scroll Event");
+        EOS_CORE_LOG_TRACE("Queued Scroll Event");
     }
 
     void EventListener::glfwWindowResizeCallback(GLFWwindow* window, int width, int height)
@@ -93,8 +128,9 @@ namespace Eos::Events
             static_cast<uint32_t>(height)
         };
 
-        dispatchEvent(event);
+        if (!s_Queue.push(event))
+            EOS_CORE_LOG_WARN("Event queue is full, dropped Window Resize Event");
 
-        EOS_CORE_LOG_TRACE("Dispatched Window Resize Event");
+        EOS_CORE_LOG_TRACE("Queued Window Resize Event");
     }
 }
@@ -6,6 +6,8 @@
 
 #include "Eos/Events/Events.hpp"
 #include "Eos/Events/EventDispatcher.hpp"
+#include "Eos/Events/EventQueue.hpp"
+#include "Eos/Events/InputState.hpp"
 
 namespace Eos::Events
 {
@@ -15,8 +17,28 @@ namespace Eos::Events
         static void setupListener(std::shared_ptr<Window>& window);
         void addDispatcher(EventDispatcher* dispatcher);
         void removeDispatcher(EventDispatcher* dispatcher);
+
+        // GLFW callbacks only queue their events, they are handed to the
+        // dispatchers here, once per frame, after the input state is updated
+        static void processEvents();
+
+        static InputState& getInputState() { return s_InputState; }
+
+        // Safe from any thread, dispatched on the next processEvents
+        template <typename T>
+        static bool pushEvent(const T& event)
+        {
+            return s_Queue.push(QueuedEvent(event));
+        }
+
+        static EventQueue& getQueue() { return s_Queue; }
     private:
         static std::vector<EventDispatcher*> s_Dispatchers;
+
+        static EventQueue s_Queue;
+        static std::vector<QueuedEvent> s_Batch;
+
+        static InputState s_InputState;
     private:
         static void glfwKeyCallback(GLFWwindow* window, int key, int scancode,
                 int action, int mods);
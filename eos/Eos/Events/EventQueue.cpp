@@ -0,0 +1,133 @@
+#include "EventQueue.hpp"
+
+namespace Eos::Events
+{
+    EventQueue::EventQueue(uint32_t capacity)
+    {
+        uint64_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        m_Slots = std::make_unique<Slot[]>(size);
+        m_Mask = size - 1;
+
+        for (uint64_t i = 0; i < size; i++)
+            m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool EventQueue::push(const QueuedEvent& event)
+    {
+        uint64_t position = m_Tail.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = m_Slots[position & m_Mask];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+            if (difference == 0)
+            {
+                if (m_Tail.compare_exchange_weak(position, position + 1,
+                            std::memory_order_relaxed))
+                {
+                    slot.event = event;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+
+                    m_Pushed.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = m_Tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool EventQueue::pop(QueuedEvent& event)
+    {
+        uint64_t position = m_Head.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = m_Slots[position & m_Mask];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            int64_t difference = static_cast<int64_t>(sequence) -
+                static_cast<int64_t>(position + 1);
+
+            if (difference == 0)
+            {
+                if (m_Head.compare_exchange_weak(position, position + 1,
+                            std::memory_order_relaxed))
+                {
+                    event = std::move(slot.event);
+                    slot.sequence.store(position + m_Mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_Head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void EventQueue::drain(std::vector<QueuedEvent>& events)
+    {
+        bool coalesce = m_Coalesce.load(std::memory_order_relaxed);
+        uint64_t coalesced = 0;
+
+        QueuedEvent event;
+        for (uint64_t i = 0; i <= m_Mask && pop(event); i++)
+        {
+            if (coalesce && !events.empty())
+            {
+                QueuedEvent& last = events.back();
+
+                if (std::holds_alternative<MouseMoveEvent>(event) &&
+                        std::holds_alternative<MouseMoveEvent>(last))
+                {
+                    last = event;
+                    coalesced++;
+                    continue;
+                }
+
+                if (std::holds_alternative<ScrollEvent>(event) &&
+                        std::holds_alternative<ScrollEvent>(last))
+                {
+                    ScrollEvent& lastScroll = std::get<ScrollEvent>(last);
+                    const ScrollEvent& scroll = std::get<ScrollEvent>(event);
+
+                    lastScroll.xOff += scroll.xOff;
+                    lastScroll.yOff += scroll.yOff;
+                    coalesced++;
+                    continue;
+                }
+            }
+
+            events.push_back(std::move(event));
+        }
+
+        if (coalesced > 0)
+            m_Coalesced.fetch_add(coalesced, std::memory_order_relaxed);
+    }
+
+    EventQueue::Statistics EventQueue::getStatistics() const
+    {
+        Statistics statistics;
+        statistics.pushed = m_Pushed.load(std::memory_order_relaxed);
+        statistics.dropped = m_Dropped.load(std::memory_order_relaxed);
+        statistics.coalesced = m_Coalesced.load(std::memory_order_relaxed);
+
+        return statistics;
+    }
+}
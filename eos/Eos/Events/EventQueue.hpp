@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Events/Events.hpp"
+
+#include <atomic>
+#include <memory>
+#include <variant>
+
+namespace Eos::Events
+{
+    using QueuedEvent = std::variant<std::monostate, KeyInputEvent, MousePressEvent,
+          MouseMoveEvent, ScrollEvent, WindowResizeEvent>;
+
+    // Bounded lock-free multi producer, multi consumer queue of events.
+    // Each slot carries a sequence number, so producers and consumers only
+    // contend on a single atomic index each
+    class EOS_API EventQueue
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t pushed = 0;
+            uint64_t dropped = 0;
+            uint64_t coalesced = 0;
+        };
+
+    public:
+        // capacity is rounded up to a power of two
+        EventQueue(uint32_t capacity = 1024);
+        ~EventQueue() {}
+
+        // Safe from any thread. Returns false, dropping the event, when full
+        bool push(const QueuedEvent& event);
+        bool pop(QueuedEvent& event);
+
+        // Pops at most capacity events into events, so producers can not keep
+        // a drain running forever. With coalescing, runs of mouse moves are
+        // reduced to the last one and runs of scrolls are summed
+        void drain(std::vector<QueuedEvent>& events);
+
+        void setCoalescing(bool coalesce) { m_Coalesce = coalesce; }
+        bool isCoalescing() const { return m_Coalesce; }
+
+        Statistics getStatistics() const;
+    private:
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence;
+            QueuedEvent event;
+        };
+
+        std::unique_ptr<Slot[]> m_Slots;
+        uint64_t m_Mask;
+
+        alignas(64) std::atomic<uint64_t> m_Head = 0;
+        alignas(64) std::atomic<uint64_t> m_Tail = 0;
+
+        std::atomic<bool> m_Coalesce = true;
+
+        std::atomic<uint64_t> m_Pushed = 0;
+        std::atomic<uint64_t> m_Dropped = 0;
+        std::atomic<uint64_t> m_Coalesced = 0;
+    };
+}
@@ -2,12 +2,10 @@
 
 #include "Eos/Events/EventCodes.hpp"
 
+#include <tuple>
+
 namespace Eos::Events {
 struct Event {
-  Type eventType;
-
-  void *dataPointer = nullptr;
-
   Event() {}
 };
 
@@ -55,4 +53,11 @@ struct WindowResizeEvent : public Event {
   WindowResizeEvent(uint32_t width, uint32_t height)
       : width(width), height(height) {}
 };
+
+// In the order of Type, so an event's index in the tuple is its eventType
+using EventTypes = std::tuple<KeyInputEvent, MousePressEvent, MouseMoveEvent,
+                              ScrollEvent, WindowResizeEvent>;
+
+static_assert(std::tuple_size_v<EventTypes> ==
+              static_cast<size_t>(Type::TYPE_COUNT));
 } // namespace Eos::Events
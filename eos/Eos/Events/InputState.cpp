@@ -0,0 +1,94 @@
+#include "InputState.hpp"
+
+namespace Eos::Events
+{
+    InputState::InputState()
+        : m_Snapshot(std::make_shared<const InputSnapshot>())
+    {}
+
+    void InputState::handleEvent(const KeyInputEvent& event)
+    {
+        size_t key = static_cast<size_t>(event.key);
+        if (key >= InputSnapshot::c_KeyCount)
+            return;
+
+        if (event.action == Action::PRESS)
+        {
+            m_Current.m_Keys.set(key);
+            m_Current.m_KeysPressed.set(key);
+        }
+        else if (event.action == Action::RELEASE)
+        {
+            m_Current.m_Keys.reset(key);
+            m_Current.m_KeysReleased.set(key);
+        }
+    }
+
+    void InputState::handleEvent(const MousePressEvent& event)
+    {
+        size_t button = static_cast<size_t>(event.button);
+        if (button >= InputSnapshot::c_ButtonCount)
+            return;
+
+        if (event.action == Action::PRESS)
+        {
+            m_Current.m_Buttons.set(button);
+            m_Current.m_ButtonsPressed.set(button);
+        }
+        else if (event.action == Action::RELEASE)
+        {
+            m_Current.m_Buttons.reset(button);
+            m_Current.m_ButtonsReleased.set(button);
+        }
+    }
+
+    void InputState::handleEvent(const MouseMoveEvent& event)
+    {
+        // The first position gives no movement
+        if (!m_HasMouse)
+        {
+            m_PreviousMouseX = event.xPos;
+            m_PreviousMouseY = event.yPos;
+            m_HasMouse = true;
+        }
+
+        m_Current.m_MouseX = event.xPos;
+        m_Current.m_MouseY = event.yPos;
+    }
+
+    void InputState::handleEvent(const ScrollEvent& event)
+    {
+        m_Current.m_ScrollX += event.xOff;
+        m_Current.m_ScrollY += event.yOff;
+    }
+
+    void InputState::update()
+    {
+        m_Current.m_MouseDeltaX = m_Current.m_MouseX - m_PreviousMouseX;
+        m_Current.m_MouseDeltaY = m_Current.m_MouseY - m_PreviousMouseY;
+        m_PreviousMouseX = m_Current.m_MouseX;
+        m_PreviousMouseY = m_Current.m_MouseY;
+
+        std::shared_ptr<const InputSnapshot> snapshot =
+            std::make_shared<const InputSnapshot>(m_Current);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Snapshot = std::move(snapshot);
+        }
+
+        m_Current.m_KeysPressed.reset();
+        m_Current.m_KeysReleased.reset();
+        m_Current.m_ButtonsPressed.reset();
+        m_Current.m_ButtonsReleased.reset();
+        m_Current.m_ScrollX = 0.0f;
+        m_Current.m_ScrollY = 0.0f;
+        m_Current.m_Frame++;
+    }
+
+    std::shared_ptr<const InputSnapshot> InputState::getSnapshot() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Snapshot;
+    }
+}
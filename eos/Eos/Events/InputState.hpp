@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Eos/EosPCH.hpp"
+
+#include "Eos/Events/Events.hpp"
+
+#include <bitset>
+#include <memory>
+#include <mutex>
+
+namespace Eos::Events
+{
+    // Input as it was at the start of a frame. Pressed and released are the
+    // edges seen during the frame before it, so a tap shorter than a frame
+    // is still reported
+    class EOS_API InputSnapshot
+    {
+    public:
+        static constexpr size_t c_KeyCount = static_cast<size_t>(Key::KEY_LAST) + 1;
+        static constexpr size_t c_ButtonCount = static_cast<size_t>(MouseButton::MOUSE_BUTTON_LAST) + 1;
+
+    public:
+        bool isKeyDown(Key key) const { return test(m_Keys, key); }
+        bool wasKeyPressed(Key key) const { return test(m_KeysPressed, key); }
+        bool wasKeyReleased(Key key) const { return test(m_KeysReleased, key); }
+
+        bool isButtonDown(MouseButton button) const { return test(m_Buttons, button); }
+        bool wasButtonPressed(MouseButton button) const { return test(m_ButtonsPressed, button); }
+        bool wasButtonReleased(MouseButton button) const { return test(m_ButtonsReleased, button); }
+
+        float getMouseX() const { return m_MouseX; }
+        float getMouseY() const { return m_MouseY; }
+
+        // Movement since the previous snapshot
+        float getMouseDeltaX() const { return m_MouseDeltaX; }
+        float getMouseDeltaY() const { return m_MouseDeltaY; }
+
+        float getScrollX() const { return m_ScrollX; }
+        float getScrollY() const { return m_ScrollY; }
+
+        uint64_t getFrame() const { return m_Frame; }
+    private:
+        friend class InputState;
+
+        std::bitset<c_KeyCount> m_Keys;
+        std::bitset<c_KeyCount> m_KeysPressed;
+        std::bitset<c_KeyCount> m_KeysReleased;
+
+        std::bitset<c_ButtonCount> m_Buttons;
+        std::bitset<c_ButtonCount> m_ButtonsPressed;
+        std::bitset<c_ButtonCount> m_ButtonsReleased;
+
+        float m_MouseX = 0.0f;
+        float m_MouseY = 0.0f;
+        float m_MouseDeltaX = 0.0f;
+        float m_MouseDeltaY = 0.0f;
+
+        float m_ScrollX = 0.0f;
+        float m_ScrollY = 0.0f;
+
+        uint64_t m_Frame = 0;
+    private:
+        template <size_t N, typename E>
+        static bool test(const std::bitset<N>& bits, E value)
+        {
+            size_t index = static_cast<size_t>(value);
+            return index < N && bits.test(index);
+        }
+    };
+
+    // Built up from the events of a frame on the main thread, then published
+    // once per frame as a snapshot any thread can hold on to
+    class EOS_API InputState
+    {
+    public:
+        InputState();
+
+        void handleEvent(const KeyInputEvent& event);
+        void handleEvent(const MousePressEvent& event);
+        void handleEvent(const MouseMoveEvent& event);
+        void handleEvent(const ScrollEvent& event);
+
+        // Publishes what was gathered and starts the next frame's edges
+        void update();
+
+        std::shared_ptr<const InputSnapshot> getSnapshot() const;
+    private:
+        InputSnapshot m_Current;
+
+        float m_PreviousMouseX = 0.0f;
+        float m_PreviousMouseY = 0.0f;
+        bool m_HasMouse = false;
+
+        std::shared_ptr<const InputSnapshot> m_Snapshot;
+        mutable std::mutex m_Mutex;
+    };
+}
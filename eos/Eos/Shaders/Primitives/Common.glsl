@@ -0,0 +1,150 @@
+// Included by every primitive kernel. Defining EOS_SUBGROUP before the
+// include switches the workgroup operations to subgroup arithmetic
+
+layout (local_size_x_id = 0) in;
+
+layout (constant_id = 1) const uint ITEMS_PER_THREAD = 4;
+
+#define OP_ADD 0
+#define OP_MIN 1
+#define OP_MAX 2
+
+shared uint s_Scratch[gl_WorkGroupSize.x];
+
+uint identity(uint op)
+{
+    return op == OP_MIN ? 0xffffffffu : 0u;
+}
+
+uint combine(uint op, uint a, uint b)
+{
+    if (op == OP_MIN)
+        return min(a, b);
+    if (op == OP_MAX)
+        return max(a, b);
+
+    return a + b;
+}
+
+#ifdef EOS_SUBGROUP
+
+uint subgroupCombine(uint op, uint value)
+{
+    if (op == OP_MIN)
+        return subgroupMin(value);
+    if (op == OP_MAX)
+        return subgroupMax(value);
+
+    return subgroupAdd(value);
+}
+
+// The result is only valid in the first invocation
+uint workgroupReduce(uint op, uint value)
+{
+    uint partial = subgroupCombine(op, value);
+    if (subgroupElect())
+        s_Scratch[gl_SubgroupID] = partial;
+
+    barrier();
+
+    uint result = identity(op);
+    if (gl_SubgroupID == 0)
+    {
+        // Loops so any number of subgroups per workgroup is handled
+        for (uint base = 0; base < gl_NumSubgroups; base += gl_SubgroupSize)
+        {
+            uint index = base + gl_SubgroupInvocationID;
+            uint total = index < gl_NumSubgroups ? s_Scratch[index] : identity(op);
+            result = combine(op, result, subgroupCombine(op, total));
+        }
+    }
+
+    barrier();
+    return result;
+}
+
+uint workgroupInclusiveAdd(uint value)
+{
+    uint inclusive = subgroupInclusiveAdd(value);
+    uint total = subgroupAdd(value);
+    if (subgroupElect())
+        s_Scratch[gl_SubgroupID] = total;
+
+    barrier();
+
+    if (gl_SubgroupID == 0)
+    {
+        uint carry = 0;
+        for (uint base = 0; base < gl_NumSubgroups; base += gl_SubgroupSize)
+        {
+            uint index = base + gl_SubgroupInvocationID;
+            uint partial = index < gl_NumSubgroups ? s_Scratch[index] : 0;
+            uint prefix = subgroupExclusiveAdd(partial);
+
+            if (index < gl_NumSubgroups)
+                s_Scratch[index] = carry + prefix;
+
+            carry += subgroupAdd(partial);
+        }
+    }
+
+    barrier();
+
+    uint result = s_Scratch[gl_SubgroupID] + inclusive;
+
+    barrier();
+    return result;
+}
+
+#else
+
+// Tree reduction, gl_WorkGroupSize.x has to be a power of two
+uint workgroupReduce(uint op, uint value)
+{
+    uint id = gl_LocalInvocationID.x;
+    s_Scratch[id] = value;
+
+    barrier();
+
+    for (uint stride = gl_WorkGroupSize.x / 2; stride > 0; stride >>= 1)
+    {
+        if (id < stride)
+            s_Scratch[id] = combine(op, s_Scratch[id], s_Scratch[id + stride]);
+
+        barrier();
+    }
+
+    uint result = s_Scratch[0];
+
+    barrier();
+    return result;
+}
+
+uint workgroupInclusiveAdd(uint value)
+{
+    uint id = gl_LocalInvocationID.x;
+    s_Scratch[id] = value;
+
+    barrier();
+
+    for (uint offset = 1; offset < gl_WorkGroupSize.x; offset <<= 1)
+    {
+        uint other = id >= offset ? s_Scratch[id - offset] : 0;
+
+        barrier();
+        s_Scratch[id] += other;
+        barrier();
+    }
+
+    uint result = s_Scratch[id];
+
+    barrier();
+    return result;
+}
+
+#endif
+
+uint workgroupExclusiveAdd(uint value)
+{
+    return workgroupInclusiveAdd(value) - value;
+}
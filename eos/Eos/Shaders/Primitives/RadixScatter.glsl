@@ -0,0 +1,64 @@
+#include "Common.glsl"
+
+#define RADIX 16
+
+layout (std430, set = 0, binding = 0) readonly buffer KeyInBuffer
+{
+    uint value[];
+} b_KeysIn;
+
+layout (std430, set = 0, binding = 1) readonly buffer ValueInBuffer
+{
+    uint value[];
+} b_ValuesIn;
+
+layout (std430, set = 0, binding = 2) writeonly buffer KeyOutBuffer
+{
+    uint value[];
+} b_KeysOut;
+
+layout (std430, set = 0, binding = 3) writeonly buffer ValueOutBuffer
+{
+    uint value[];
+} b_ValuesOut;
+
+layout (std430, set = 0, binding = 4) readonly buffer OffsetBuffer
+{
+    uint value[];
+} b_Offsets;
+
+layout (push_constant) uniform Constants
+{
+    uint count;
+    uint shift;
+    uint groupCount;
+} p_Constants;
+
+// Stable: the rank of a key among the keys with the same digit in its
+// workgroup keeps the input order
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    bool valid = index < p_Constants.count;
+
+    uint key = valid ? b_KeysIn.value[index] : 0;
+    uint digit = valid ? (key >> p_Constants.shift) & (RADIX - 1) : RADIX;
+
+    uint rank = 0;
+    for (uint d = 0; d < RADIX; d++)
+    {
+        uint flag = digit == d ? 1 : 0;
+        uint inclusive = workgroupInclusiveAdd(flag);
+
+        if (flag != 0)
+            rank = inclusive - 1;
+    }
+
+    if (!valid)
+        return;
+
+    uint destination = b_Offsets.value[digit * p_Constants.groupCount + gl_WorkGroupID.x] + rank;
+
+    b_KeysOut.value[destination] = key;
+    b_ValuesOut.value[destination] = b_ValuesIn.value[index];
+}
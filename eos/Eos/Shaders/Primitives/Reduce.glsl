@@ -0,0 +1,38 @@
+#include "Common.glsl"
+
+layout (constant_id = 2) const uint OP = OP_ADD;
+
+layout (std430, set = 0, binding = 0) readonly buffer InBuffer
+{
+    uint value[];
+} b_In;
+
+layout (std430, set = 0, binding = 1) writeonly buffer OutBuffer
+{
+    uint value[];
+} b_Out;
+
+layout (push_constant) uniform Constants
+{
+    uint count;
+} p_Constants;
+
+// Each workgroup writes one partial result
+void main()
+{
+    uint blockSize = gl_WorkGroupSize.x * ITEMS_PER_THREAD;
+    uint base = gl_WorkGroupID.x * blockSize + gl_LocalInvocationID.x;
+
+    uint value = identity(OP);
+    for (uint i = 0; i < ITEMS_PER_THREAD; i++)
+    {
+        uint index = base + i * gl_WorkGroupSize.x;
+        if (index < p_Constants.count)
+            value = combine(OP, value, b_In.value[index]);
+    }
+
+    value = workgroupReduce(OP, value);
+
+    if (gl_LocalInvocationID.x == 0)
+        b_Out.value[gl_WorkGroupID.x] = value;
+}
@@ -0,0 +1,54 @@
+#include "Common.glsl"
+
+layout (std430, set = 0, binding = 0) buffer InBuffer
+{
+    uint value[];
+} b_In;
+
+layout (std430, set = 0, binding = 1) buffer OutBuffer
+{
+    uint value[];
+} b_Out;
+
+layout (std430, set = 0, binding = 2) buffer BlockBuffer
+{
+    uint value[];
+} b_Blocks;
+
+layout (push_constant) uniform Constants
+{
+    uint count;
+    uint exclusive;
+    uint writeBlockSums;
+} p_Constants;
+
+// Scans one block per workgroup, each invocation owning ITEMS_PER_THREAD
+// consecutive values. In and Out may be the same buffer
+void main()
+{
+    uint start = gl_GlobalInvocationID.x * ITEMS_PER_THREAD;
+
+    uint total = 0;
+    for (uint i = 0; i < ITEMS_PER_THREAD; i++)
+    {
+        if (start + i < p_Constants.count)
+            total += b_In.value[start + i];
+    }
+
+    uint running = workgroupExclusiveAdd(total);
+    uint blockTotal = running + total;
+
+    for (uint i = 0; i < ITEMS_PER_THREAD; i++)
+    {
+        uint index = start + i;
+        if (index >= p_Constants.count)
+            break;
+
+        uint value = b_In.value[index];
+        b_Out.value[index] = p_Constants.exclusive != 0 ? running : running + value;
+        running += value;
+    }
+
+    if (p_Constants.writeBlockSums != 0 && gl_LocalInvocationID.x == gl_WorkGroupSize.x - 1)
+        b_Blocks.value[gl_WorkGroupID.x] = blockTotal;
+}
@@ -60,14 +60,6 @@ private:
     Eos::IndexedMesh<Vertex, uint16_t> m_CubeMesh;
 
     Eos::PerspectiveCamera m_Camera;
-
-    std::unordered_map<Eos::Events::Key, bool> m_ActiveKeys;
-
-    float m_PreviousMouseX = -1.0f;
-    float m_PreviousMouseY = -1.0f;
-    bool m_CapturedMouse = false;
-    bool m_RightClick = false;
-
 private:
     void windowInit() override
     {
@@ -113,10 +105,6 @@ private:
 
     void postEngineInit() override
     {
-        m_MainEventDispatcher.addCallback(&keyboardEvent, this);
-        m_MainEventDispatcher.addCallback(&mouseMoveEvent, this);
-        m_MainEventDispatcher.addCallback(&mousePressEvent, this);
-
         m_Camera = Eos::PerspectiveCamera(m_Window->getSize());
         m_Camera.setNearClippingPlane(0.1f);
         m_Camera.setFarClippingPlane(200.0f);
@@ -240,6 +228,30 @@ private:
 
     void update(double dt) override
     {
+        namespace EE = Eos::Events;
+
+        if (m_Input->wasKeyPressed(EE::Key::KEY_ESCAPE))
+            m_Window->setWindowShouldClose(true);
+
+        // Look around while the right button is held. Both edges can land in
+        // one frame, so the cursor follows the button's current state
+        if (m_Input->wasButtonPressed(EE::MouseButton::MOUSE_BUTTON_RIGHT) ||
+                m_Input->wasButtonReleased(EE::MouseButton::MOUSE_BUTTON_RIGHT))
+        {
+            m_Window->setInputMode(GLFW_CURSOR,
+                    m_Input->isButtonDown(EE::MouseButton::MOUSE_BUTTON_RIGHT) ?
+                    GLFW_CURSOR_HIDDEN : GLFW_CURSOR_NORMAL);
+        }
+
+        if (m_Input->isButtonDown(EE::MouseButton::MOUSE_BUTTON_RIGHT) &&
+                !m_Input->wasButtonPressed(EE::MouseButton::MOUSE_BUTTON_RIGHT))
+        {
+            const float mouseSens = 0.5f;
+
+            m_Camera.getPitch() -= m_Input->getMouseDeltaY() * mouseSens;
+            m_Camera.getYaw() -= m_Input->getMouseDeltaX() * mouseSens;
+        }
+
         float movementAmount = 5.0f * dt;
 
         glm::vec3 front = m_Camera.getFrontVector() * movementAmount;
@@ -247,21 +259,21 @@ private:
         glm::vec3 up = m_Camera.getUpVector() * movementAmount;
 
         // Up / Down
-        if (m_ActiveKeys[Eos::Events::Key::KEY_SPACE])
+        if (m_Input->isKeyDown(EE::Key::KEY_SPACE))
             m_Camera.getPosition() -= up;
-        else if (m_ActiveKeys[Eos::Events::Key::KEY_LEFT_CONTROL])
+        else if (m_Input->isKeyDown(EE::Key::KEY_LEFT_CONTROL))
             m_Camera.getPosition() += up;
 
         // Left / Right
-        if (m_ActiveKeys[Eos::Events::Key::KEY_A])
+        if (m_Input->isKeyDown(EE::Key::KEY_A))
             m_Camera.getPosition() -= right;
-        else if (m_ActiveKeys[Eos::Events::Key::KEY_D])
+        else if (m_Input->isKeyDown(EE::Key::KEY_D))
             m_Camera.getPosition() += right;
 
         // Forward / Back
-        if (m_ActiveKeys[Eos::Events::Key::KEY_W])
+        if (m_Input->isKeyDown(EE::Key::KEY_W))
             m_Camera.getPosition() += front;
-        else if (m_ActiveKeys[Eos::Events::Key::KEY_S])
+        else if (m_Input->isKeyDown(EE::Key::KEY_S))
             m_Camera.getPosition() -= front;
 
         updateData();
@@ -282,74 +294,6 @@ private:
             memcpy(temp, &modelData, sizeof(ModelData));
         vmaUnmapMemory(Eos::GlobalData::getAllocator(), m_CubeDataBuffer.allocation);
     }
-
-    static bool keyboardEvent(const Eos::Events::KeyInputEvent* event)
-    {
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        if (event->action == Eos::Events::Action::PRESS)
-            sb->m_ActiveKeys[event->key] = true;
-        else if (event->action == Eos::Events::Action::RELEASE)
-            sb->m_ActiveKeys[event->key] = false;
-
-        if (sb->m_ActiveKeys[Eos::Events::Key::KEY_ESCAPE])
-            sb->m_Window->setWindowShouldClose(true);
-
-        return true;
-    }
-
-    static bool mouseMoveEvent(const Eos::Events::MouseMoveEvent* event)
-    {
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        if (!sb->m_RightClick)
-            return false;
-
-        if (!sb->m_CapturedMouse)
-        {
-            sb->m_PreviousMouseX = event->xPos;
-            sb->m_PreviousMouseY = event->yPos;
-
-            sb->m_CapturedMouse = true;
-        }
-
-        const float mouseSens = 0.5f;
-
-        float offsetX = (sb->m_PreviousMouseX - event->xPos) * mouseSens;
-        float offsetY = (sb->m_PreviousMouseY - event->yPos) * mouseSens;
-
-        sb->m_Camera.getPitch() += offsetY;
-        sb->m_Camera.getYaw() += offsetX;
-
-        sb->m_PreviousMouseX = event->xPos;
-        sb->m_PreviousMouseY = event->yPos;
-
-        sb->updateData();
-
-        return true;
-    }
-
-    static bool mousePressEvent(const Eos::Events::MousePressEvent* event)
-    {
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        if (event->button == Eos::Events::MouseButton::MOUSE_BUTTON_RIGHT)
-        {
-            if (event->action == Eos::Events::Action::PRESS)
-            {
-                sb->m_RightClick = true;
-                sb->m_Window->setInputMode(GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
-                sb->m_CapturedMouse = false;
-            }
-            else
-            {
-                sb->m_RightClick = false;
-                sb->m_Window->setInputMode(GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-            }
-        }
-
-        return true;
-    }
 };
 
 Eos::Application* Eos::createApplication()
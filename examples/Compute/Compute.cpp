@@ -17,6 +17,9 @@ private:
 
     VkPipeline m_Pipeline;
     VkPipelineLayout m_PipelineLayout;
+
+    uint32_t m_Elements = 0;
+    bool m_Dispatched = false;
 private:
     void windowInit() override
     {
@@ -33,8 +36,10 @@ private:
                 VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
         m_InBuffer.addToDeletionQueue(Eos::GlobalData::getDeletionQueue());
 
-        m_OutBuffer.create(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+        // Only read through the readback ring, so it can stay in device memory
+        m_OutBuffer.create(bufferSize,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VMA_MEMORY_USAGE_AUTO);
         m_OutBuffer.addToDeletionQueue(Eos::GlobalData::getDeletionQueue());
 
         int32_t values[elements];
@@ -79,85 +84,32 @@ private:
             .setShaderStage(squareShader.getShaderStage())
             .build(m_Pipeline, m_PipelineLayout, layoutInfo);
 
-        /* VkCommandPoolCreateInfo commandPoolCI = Eos::Init::commandPoolCreateInfo( */
-        /*         m_Engine->getComputeQueue().family,  */
-        /*         VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT); */
-        /**/
-        /* VkCommandPool commandPool; */
-        /**/
-        /* EOS_VK_CHECK(vkCreateCommandPool(Eos::GlobalData::getDevice(), &commandPoolCI, */
-        /*             nullptr, &commandPool)); */
-        /**/
-        /* VkCommandBufferAllocateInfo cmdAllocInfo = Eos::Init::commandBufferAllocateInfo( */
-        /*         commandPool, 1); */
-        /**/
-        /* VkCommandBuffer cmd; */
-        /* EOS_VK_CHECK(vkAllocateCommandBuffers(Eos::GlobalData::getDevice(), */
-        /*             &cmdAllocInfo, &cmd)); */
-        /**/
-        /* VkCommandBufferBeginInfo cmdBeginInfo{}; */
-        /* cmdBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO; */
-        /* cmdBeginInfo.pNext = nullptr; */
-        /* cmdBeginInfo.pInheritanceInfo = nullptr; */
-        /* cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; */
-        /**/
-        /* EOS_VK_CHECK(vkBeginCommandBuffer(cmd, &cmdBeginInfo)); */
-        VkCommandBuffer cmd = Eos::ComputeShader::getCommandBuffer();
+        m_Elements = elements;
+    }
 
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, 
-                m_PipelineLayout, 0, 1, &m_Set, 0, nullptr);
+    void prepare(VkCommandBuffer cmd) override
+    {
+        if (m_Dispatched)
+            return;
 
-        vkCmdDispatch(cmd, elements, 1, 1);
-
-        /* EOS_VK_CHECK(vkEndCommandBuffer(cmd)); */
-
-        Eos::ComputeShader::endAndWait(cmd);
-
-        Eos::ComputeShader::resetCommandBuffer(cmd);
-
-        /* VkFenceCreateInfo fenceCI = Eos::Init::fenceCreateInfo(); */
-        /* VkFence fence; */
-        /* EOS_VK_CHECK(vkCreateFence(Eos::GlobalData::getDevice(), &fenceCI, nullptr, */
-        /*             &fence)); */
-        /**/
-        /* VkSubmitInfo submit{}; */
-        /* submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO; */
-        /* submit.pNext = nullptr; */
-        /* submit.pWaitDstStageMask = nullptr; */
-        /* submit.waitSemaphoreCount = 0; */
-        /* submit.pWaitSemaphores = nullptr; */
-        /* submit.commandBufferCount = 1; */
-        /* submit.pCommandBuffers = &cmd; */
-        /**/
-        /* EOS_VK_CHECK(vkQueueSubmit(m_Engine->getComputeQueue().queue, */
-        /*             1, &submit, */
-        /*             fence)); */
-        /* EOS_VK_CHECK(vkWaitForFences(Eos::GlobalData::getDevice(), */
-        /*             1, &fence, true, 10000000)); */
-
-        int32_t returnValuesInput[elements];
-        int32_t returnValuesOutput[elements];
+        m_Dispatched = true;
 
-        vmaMapMemory(Eos::GlobalData::getAllocator(), m_InBuffer.allocation, &temp);
-            memcpy(returnValuesInput, temp, bufferSize);
-        vmaUnmapMemory(Eos::GlobalData::getAllocator(), m_InBuffer.allocation);
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                m_PipelineLayout, 0, 1, &m_Set, 0, nullptr);
 
-        vmaMapMemory(Eos::GlobalData::getAllocator(), m_OutBuffer.allocation, &temp);
-            memcpy(returnValuesOutput, temp, bufferSize);
-        vmaUnmapMemory(Eos::GlobalData::getAllocator(), m_OutBuffer.allocation);
+        vkCmdDispatch(cmd, m_Elements, 1, 1);
 
-        for (int i = 0; i < elements; i++)
-        {
-            EOS_CORE_LOG_INFO("{} : {}", returnValuesInput[i], returnValuesOutput[i]);
-        }
+        // The results arrive a few frames later, the frame never waits on them
+        m_Engine->getReadback().readBuffer(cmd, m_OutBuffer, 0, m_OutBuffer.size,
+                [elements = m_Elements](const void* data, VkDeviceSize size) {
+                    const int32_t* values = static_cast<const int32_t*>(data);
 
-        /* vkDeviceWaitIdle(Eos::GlobalData::getDevice()); */
-        /**/
-        /* vkResetCommandPool(Eos::GlobalData::getDevice(), commandPool, */
-        /*         VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT); */
-        /* vkDestroyFence(Eos::GlobalData::getDevice(), fence, nullptr); */
-        /* vkDestroyCommandPool(Eos::GlobalData::getDevice(), commandPool, nullptr); */
+                    for (uint32_t i = 0; i < elements; i++)
+                    {
+                        EOS_LOG_INFO("{} : {}", i + 1, values[i]);
+                    }
+                }, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
     }
 
     std::vector<VkClearValue> renderClearValues() override
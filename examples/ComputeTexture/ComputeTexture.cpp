@@ -56,9 +56,18 @@ private:
     VkPipeline m_RenderPipeline;
     VkPipelineLayout m_RenderPipelineLayout;
 
+    struct WorkgroupSize
+    {
+        uint32_t x = 16;
+        uint32_t y = 16;
+    } m_WorkgroupSize;
+
     Eos::Texture2D m_ComputeTexture;
     Eos::Texture2D m_RenderTexture;
 
+    // Set when the textures are recreated, the next frame fills them
+    bool m_ComputeDirty = false;
+
     Eos::IndexedMesh<Vertex, uint16_t> m_Mesh;
 private:
     void windowInit() override
@@ -69,7 +78,7 @@ private:
 
     void postEngineInit() override
     {
-        m_MainEventDispatcher.addCallback(&windowResizeEvent, this);
+        m_MainEventDispatcher.addCallback<&Sandbox::windowResizeEvent>(this);
 
         std::vector<Vertex> vertices = {
             { { -1.0f,  1.0f, 1.0f }, { 0.0f, 0.0f } },
@@ -104,6 +113,10 @@ private:
         // Compute
         Eos::ComputeShader compShader;
         compShader.addShaderModule("res/ComputeTexture/Shaders/Main.comp.spv");
+        compShader.setSpecialization(Eos::SpecializationConstants::fromStruct(m_WorkgroupSize, {
+                    EOS_SPECIALIZATION_ENTRY(0, WorkgroupSize, x),
+                    EOS_SPECIALIZATION_ENTRY(1, WorkgroupSize, y)
+                }));
 
         m_ComputeTexture.createImage(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, extent,
                 VMA_MEMORY_USAGE_GPU_ONLY);
@@ -116,14 +129,6 @@ private:
         m_RenderTexture.createSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
         m_RenderTexture.addToDeletionQueue(Eos::GlobalData::getDeletionQueue());
 
-        m_ComputeTexture.convertImageLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
-            0, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-
-        m_RenderTexture.convertImageLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            0, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-
         VkDescriptorImageInfo computeImageInfo;
         computeImageInfo.imageView = m_ComputeTexture.imageView;
         computeImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
@@ -136,34 +141,10 @@ private:
         layoutInfo.pSetLayouts = &m_ComputeSetLayout;
 
         m_Engine->createComputePipelineBuilder()
-            .setShaderStage(compShader.getShaderStage())
+            .setShader(compShader)
             .build(m_ComputePipeline, m_ComputePipelineLayout, layoutInfo);
 
-        VkCommandBuffer cmd = Eos::ComputeShader::getCommandBuffer();
-
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_ComputePipeline);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, 
-                m_ComputePipelineLayout, 0, 1, &m_ComputeSet, 0, nullptr);
-
-        uint32_t xCalls = (uint32_t)std::ceil(extent.width / 32.0f);
-        uint32_t yCalls = (uint32_t)std::ceil(extent.height / 32.0f);
-
-        vkCmdDispatch(cmd, xCalls, yCalls, 1);
-
-        Eos::ComputeShader::endAndWait(cmd);
-
-        Eos::ComputeShader::resetCommandBuffer(cmd);
-
-        m_ComputeTexture.convertImageLayout(VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-            0, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-
-        Eos::Texture2D::blitBetween(m_ComputeTexture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                m_RenderTexture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_FILTER_NEAREST);
-
-        m_RenderTexture.convertImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            0, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        m_ComputeDirty = true;
 
         // Rendering
         Eos::Shader shader;
@@ -205,6 +186,38 @@ private:
         createPipelines();
     }
 
+    void prepare(VkCommandBuffer cmd) override
+    {
+        if (!m_ComputeDirty)
+            return;
+
+        m_ComputeDirty = false;
+
+        Eos::BarrierBatcher barriers;
+        barriers.transition(m_ComputeTexture, Eos::Access::ComputeShaderWrite)
+            .flush(cmd);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_ComputePipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                m_ComputePipelineLayout, 0, 1, &m_ComputeSet, 0, nullptr);
+
+        uint32_t xCalls = (m_ComputeTexture.extent.width + m_WorkgroupSize.x - 1) / m_WorkgroupSize.x;
+        uint32_t yCalls = (m_ComputeTexture.extent.height + m_WorkgroupSize.y - 1) / m_WorkgroupSize.y;
+
+        vkCmdDispatch(cmd, xCalls, yCalls, 1);
+
+        barriers.transition(m_ComputeTexture, Eos::Access::TransferSrc)
+            .transition(m_RenderTexture, Eos::Access::TransferDst)
+            .flush(cmd);
+
+        Eos::Texture2D::blitBetween(cmd,
+                m_ComputeTexture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                m_RenderTexture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_FILTER_NEAREST);
+
+        barriers.transition(m_RenderTexture, Eos::Access::FragmentShaderRead)
+            .flush(cmd);
+    }
+
     void draw(VkCommandBuffer cmd) override
     {
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_RenderPipeline);
@@ -219,11 +232,9 @@ private:
         vkCmdDrawIndexed(cmd, m_Mesh.getIndices()->size(), 1, 0, 0, 0);
     }
 
-    static bool windowResizeEvent(const Eos::Events::WindowResizeEvent* event)
+    bool windowResizeEvent(const Eos::Events::WindowResizeEvent& event)
     {
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        sb->recreatePipelines();
+        recreatePipelines();
 
         return true;
     }
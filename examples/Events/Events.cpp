@@ -51,9 +51,9 @@ private:
 
     void postEngineInit() override
     {
-        m_MainEventDispatcher.addCallback(&keyboardEvent, this);
-        m_MainEventDispatcher.addCallback(&mouseMoveEvent, this);
-        m_MainEventDispatcher.addCallback(&mousePressEvent, this);
+        m_MainEventDispatcher.addCallback<&Sandbox::keyboardEvent>(this);
+        m_MainEventDispatcher.addCallback<&Sandbox::mouseMoveEvent>(this);
+        m_MainEventDispatcher.addCallback<&Sandbox::mousePressEvent>(this);
 
         std::vector<Vertex> vertices = {
             { { -1.0f,  1.0f, 0.0f} },
@@ -99,44 +99,38 @@ private:
 
     void update(double dt) override {}
 
-    static bool keyboardEvent(const Eos::Events::KeyInputEvent* event)
+    bool keyboardEvent(const Eos::Events::KeyInputEvent& event)
     {
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        if (event->key == Eos::Events::Key::KEY_ESCAPE &&
-                event->action == Eos::Events::Action::PRESS)
+        if (event.key == Eos::Events::Key::KEY_ESCAPE &&
+                event.action == Eos::Events::Action::PRESS)
         {
-            sb->m_Window->setWindowShouldClose(true);
+            m_Window->setWindowShouldClose(true);
         }
 
-        if (static_cast<int>(event->key) >= 65 && static_cast<int>(event->key) <= 90)
+        if (static_cast<int>(event.key) >= 65 && static_cast<int>(event.key) <= 90)
         {
-            if (event->action == Eos::Events::Action::PRESS)
+            if (event.action == Eos::Events::Action::PRESS)
             {
-                EOS_CORE_LOG_INFO("{}", (char)(static_cast<int>(event->key)));
+                EOS_CORE_LOG_INFO("{}", (char)(static_cast<int>(event.key)));
             }
         }
 
         return true;
     }
 
-    static bool mouseMoveEvent(const Eos::Events::MouseMoveEvent* event)
+    bool mouseMoveEvent(const Eos::Events::MouseMoveEvent& event)
     {
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        sb->m_MouseX = event->xPos;
-        sb->m_MouseY = event->yPos;
+        m_MouseX = event.xPos;
+        m_MouseY = event.yPos;
 
         return true;
     }
 
-    static bool mousePressEvent(const Eos::Events::MousePressEvent* event)
+    bool mousePressEvent(const Eos::Events::MousePressEvent& event)
     {
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        if (event->action == Eos::Events::Action::PRESS)
+        if (event.action == Eos::Events::Action::PRESS)
         {
-            EOS_CORE_LOG_INFO("{} {}", sb->m_MouseX, sb->m_MouseY);
+            EOS_CORE_LOG_INFO("{} {}", m_MouseX, m_MouseY);
         }
 
         return true;
@@ -66,10 +66,6 @@ private:
 
     float m_PosX = 250.0f;
     float m_PosY = 250.0f;
-    float m_VelX = 0.0f;
-    float m_VelY = 0.0f;
-    float m_VelCameraX = 0.0f;
-    float m_VelCameraY = 0.0f;
 
     float m_MovementSpeed = 100.0f;
 private:
@@ -84,8 +80,6 @@ private:
         m_Camera = Eos::OrthographicCamera(m_Window->getSize());
         m_Camera.setPosition({ 100.0f, 0.0f, 0.0f });
 
-        m_MainEventDispatcher.addCallback(&keyboardEvent, this);
-
         std::vector<Vertex> vertices = {
             { { -1.0f,  1.0f, 0.0f}, { 1.0f, 0.0, 0.0 } },
             { {  1.0f,  1.0f, 0.0f}, { 1.0f, 0.0, 0.0 } },
@@ -162,10 +156,41 @@ private:
 
     void update(double dt) override
     {
-        m_PosX += m_VelX * m_MovementSpeed * dt;
-        m_PosY += m_VelY * m_MovementSpeed * dt;
-        m_Camera.getPosition().x += m_VelCameraX * m_MovementSpeed * dt;
-        m_Camera.getPosition().y += m_VelCameraY * m_MovementSpeed * dt;
+        namespace EE = Eos::Events;
+
+        if (m_Input->wasKeyPressed(EE::Key::KEY_ESCAPE))
+        {
+            m_Window->setWindowShouldClose(true);
+        }
+
+        float velX = 0.0f;
+        if (m_Input->isKeyDown(EE::Key::KEY_A))
+            velX += -1.0f;
+        else if (m_Input->isKeyDown(EE::Key::KEY_D))
+            velX += 1.0f;
+
+        float velY = 0.0f;
+        if (m_Input->isKeyDown(EE::Key::KEY_S))
+            velY += 1.0f;
+        else if (m_Input->isKeyDown(EE::Key::KEY_W))
+            velY += -1.0f;
+
+        float velCameraX = 0.0f;
+        if (m_Input->isKeyDown(EE::Key::KEY_LEFT))
+            velCameraX += -1.0f;
+        else if (m_Input->isKeyDown(EE::Key::KEY_RIGHT))
+            velCameraX += 1.0f;
+
+        float velCameraY = 0.0f;
+        if (m_Input->isKeyDown(EE::Key::KEY_DOWN))
+            velCameraY += 1.0f;
+        else if (m_Input->isKeyDown(EE::Key::KEY_UP))
+            velCameraY += -1.0f;
+
+        m_PosX += velX * m_MovementSpeed * dt;
+        m_PosY += velY * m_MovementSpeed * dt;
+        m_Camera.getPosition().x += velCameraX * m_MovementSpeed * dt;
+        m_Camera.getPosition().y += velCameraY * m_MovementSpeed * dt;
         updateData();
     }
 
@@ -182,54 +207,6 @@ private:
             memcpy(tempBuffer, &m_Data, sizeof(Data));
         vmaUnmapMemory(Eos::GlobalData::getAllocator(), m_DataBuffer.allocation);
     }
-
-    static bool keyboardEvent(const Eos::Events::KeyInputEvent* event)
-    {
-        namespace EE = Eos::Events;
-
-        static std::unordered_map<Eos::Events::Key, bool> activeKeys;
-        Sandbox* sb = (Sandbox*)event->dataPointer;
-
-        if (event->key == EE::Key::KEY_ESCAPE && event->action == EE::Action::PRESS)
-        {
-            sb->m_Window->setWindowShouldClose(true);
-        }
-
-        if (event->action == EE::Action::PRESS)
-        {
-            activeKeys[event->key] = true;
-        }
-        else if (event->action == EE::Action::RELEASE)
-        {
-            activeKeys[event->key] = false;
-        }
-
-        sb->m_VelX = 0.0f;
-        if (activeKeys[EE::Key::KEY_A])
-            sb->m_VelX += -1.0f;
-        else if (activeKeys[EE::Key::KEY_D])
-            sb->m_VelX += 1.0f;
-
-        sb->m_VelY = 0.0f;
-        if (activeKeys[EE::Key::KEY_S])
-            sb->m_VelY += 1.0f;
-        else if (activeKeys[EE::Key::KEY_W])
-            sb->m_VelY += -1.0f;
-
-        sb->m_VelCameraX = 0.0f;
-        if (activeKeys[EE::Key::KEY_LEFT])
-            sb->m_VelCameraX += -1.0f;
-        else if (activeKeys[EE::Key::KEY_RIGHT])
-            sb->m_VelCameraX += 1.0f;
-
-        sb->m_VelCameraY = 0.0f;
-        if (activeKeys[EE::Key::KEY_DOWN])
-            sb->m_VelCameraY += 1.0f;
-        else if (activeKeys[EE::Key::KEY_UP])
-            sb->m_VelCameraY += -1.0f;
-
-        return true;
-    }
 };
 
 Eos::Application* Eos::createApplication()
@@ -0,0 +1,263 @@
+#include "Eos/Eos.hpp"
+#include "Eos/Core/EntryPoint.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+class Sandbox : public Eos::Application
+{
+public:
+    Sandbox(const Eos::ApplicationDetails& details)
+        : Eos::Application(details) {}
+
+    ~Sandbox() {}
+private:
+    // Several blocks per scan level, so the recursive paths are covered
+    static constexpr uint32_t s_Count = (1 << 20) + 123;
+
+    uint32_t m_Passed = 0;
+    uint32_t m_Failed = 0;
+private:
+    void windowInit() override
+    {
+        m_Window->setWindowSize({ 500, 500 });
+        m_Window->create("GPU Primitives");
+    }
+
+    void postEngineInit() override
+    {
+        Eos::GpuPrimitives& primitives = m_Engine->getPrimitives();
+
+        if (primitives.subgroupsSupported())
+        {
+            EOS_LOG_INFO("Checking subgroup kernels");
+            runChecks();
+        }
+
+        primitives.setUseSubgroups(false);
+
+        EOS_LOG_INFO("Checking shared memory kernels");
+        runChecks();
+
+        EOS_LOG_INFO("{} checks passed, {} failed", m_Passed, m_Failed);
+    }
+
+    void runChecks()
+    {
+        Eos::GpuPrimitives& primitives = m_Engine->getPrimitives();
+
+        std::mt19937 generator(1234);
+        std::uniform_int_distribution<uint32_t> smallValues(0, 1000);
+        std::uniform_int_distribution<uint32_t> keyValues;
+
+        std::vector<uint32_t> values(s_Count);
+        for (uint32_t& value : values)
+            value = smallValues(generator);
+
+        Eos::Buffer input = createBuffer(s_Count);
+        Eos::Buffer output = createBuffer(s_Count);
+        upload(input, values);
+
+        // Reduce
+        for (Eos::ReduceOp op : { Eos::ReduceOp::Add, Eos::ReduceOp::Min, Eos::ReduceOp::Max })
+        {
+            run([&](VkCommandBuffer cmd) {
+                primitives.reduce(cmd, input, output, s_Count, op);
+            });
+
+            uint32_t expected;
+            if (op == Eos::ReduceOp::Add)
+                expected = std::accumulate(values.begin(), values.end(), 0u);
+            else if (op == Eos::ReduceOp::Min)
+                expected = *std::min_element(values.begin(), values.end());
+            else
+                expected = *std::max_element(values.begin(), values.end());
+
+            check("Reduce", download(output, 1)[0] == expected);
+        }
+
+        // Scans
+        std::vector<uint32_t> expected(s_Count);
+
+        run([&](VkCommandBuffer cmd) {
+            primitives.inclusiveScan(cmd, input, output, s_Count);
+        });
+
+        std::inclusive_scan(values.begin(), values.end(), expected.begin());
+        check("Inclusive Scan", download(output, s_Count) == expected);
+
+        run([&](VkCommandBuffer cmd) {
+            primitives.exclusiveScan(cmd, input, output, s_Count);
+        });
+
+        std::exclusive_scan(values.begin(), values.end(), expected.begin(), 0u);
+        check("Exclusive Scan", download(output, s_Count) == expected);
+
+        // Compaction
+        std::vector<uint32_t> flags(s_Count);
+        for (uint32_t i = 0; i < s_Count; i++)
+            flags[i] = values[i] % 3 == 0 ? 1 : 0;
+
+        Eos::Buffer flagBuffer = createBuffer(s_Count);
+        Eos::Buffer countBuffer = createBuffer(1);
+        upload(flagBuffer, flags);
+
+        run([&](VkCommandBuffer cmd) {
+            primitives.compact(cmd, input, flagBuffer, output, countBuffer, s_Count);
+        });
+
+        std::vector<uint32_t> kept;
+        for (uint32_t i = 0; i < s_Count; i++)
+        {
+            if (flags[i] != 0)
+                kept.push_back(values[i]);
+        }
+
+        uint32_t keptCount = download(countBuffer, 1)[0];
+        check("Compact", keptCount == kept.size() &&
+                download(output, keptCount) == kept);
+
+        // Radix sort, values are the original indices to check stability
+        std::vector<uint32_t> keys(s_Count);
+        std::vector<uint32_t> indices(s_Count);
+        for (uint32_t i = 0; i < s_Count; i++)
+        {
+            keys[i] = keyValues(generator);
+            indices[i] = i;
+        }
+
+        // Keys that need the sort to be stable
+        for (uint32_t i = 0; i < s_Count; i += 7)
+            keys[i] = 42;
+
+        Eos::Buffer keyBuffer = createBuffer(s_Count);
+        upload(keyBuffer, keys);
+        upload(output, indices);
+
+        run([&](VkCommandBuffer cmd) {
+            primitives.radixSort(cmd, keyBuffer, output, s_Count);
+        });
+
+        std::stable_sort(indices.begin(), indices.end(),
+                [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+        std::vector<uint32_t> sortedKeys(s_Count);
+        for (uint32_t i = 0; i < s_Count; i++)
+            sortedKeys[i] = keys[indices[i]];
+
+        check("Radix Sort", download(keyBuffer, s_Count) == sortedKeys &&
+                download(output, s_Count) == indices);
+
+        // Histogram, in shared memory and straight to the buffer
+        for (uint32_t binCount : { 256u, 4096u })
+        {
+            Eos::Buffer bins = createBuffer(binCount);
+
+            run([&](VkCommandBuffer cmd) {
+                primitives.histogram(cmd, input, bins, s_Count, binCount);
+            });
+
+            std::vector<uint32_t> counts(binCount, 0);
+            for (uint32_t value : values)
+            {
+                if (value < binCount)
+                    counts[value]++;
+            }
+
+            check("Histogram", download(bins, binCount) == counts);
+
+            bins.destroy();
+        }
+
+        // Checks are run more than once, so nothing is left for the deletion queue
+        input.destroy();
+        output.destroy();
+        flagBuffer.destroy();
+        countBuffer.destroy();
+        keyBuffer.destroy();
+    }
+
+    Eos::Buffer createBuffer(uint32_t count)
+    {
+        Eos::Buffer buffer;
+        buffer.create(count * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_AUTO,
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+
+        return buffer;
+    }
+
+    void upload(Eos::Buffer& buffer, const std::vector<uint32_t>& data)
+    {
+        void* temp;
+        vmaMapMemory(Eos::GlobalData::getAllocator(), buffer.allocation, &temp);
+            memcpy(temp, data.data(), data.size() * sizeof(uint32_t));
+        vmaUnmapMemory(Eos::GlobalData::getAllocator(), buffer.allocation);
+    }
+
+    std::vector<uint32_t> download(Eos::Buffer& buffer, uint32_t count)
+    {
+        std::vector<uint32_t> data(count);
+
+        void* temp;
+        vmaMapMemory(Eos::GlobalData::getAllocator(), buffer.allocation, &temp);
+            memcpy(data.data(), temp, count * sizeof(uint32_t));
+        vmaUnmapMemory(Eos::GlobalData::getAllocator(), buffer.allocation);
+
+        return data;
+    }
+
+    void run(std::function<void(VkCommandBuffer)>&& function)
+    {
+        Eos::ComputeTicket ticket = m_Engine->getComputeJobs().submit([&](VkCommandBuffer cmd) {
+            Eos::BarrierBatcher()
+                .memoryBarrier(VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_WRITE_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                        VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT)
+                .flush(cmd);
+
+            function(cmd);
+
+            Eos::BarrierBatcher()
+                .memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                        VK_ACCESS_2_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_2_HOST_BIT,
+                        VK_ACCESS_2_HOST_READ_BIT)
+                .flush(cmd);
+        });
+
+        ticket.wait();
+    }
+
+    void check(const char* name, bool passed)
+    {
+        if (passed)
+        {
+            m_Passed++;
+            EOS_LOG_INFO("{} matches the CPU reference", name);
+        }
+        else
+        {
+            m_Failed++;
+            EOS_LOG_ERROR("{} does not match the CPU reference", name);
+        }
+    }
+
+    std::vector<VkClearValue> renderClearValues() override
+    {
+        return { { { { 0.1f, 0.1f, 0.1f, 1.0f } } } };
+    }
+
+    void draw(VkCommandBuffer cmd) override {}
+
+    void update(double dt) override {}
+};
+
+Eos::Application* Eos::createApplication()
+{
+    ApplicationDetails details{};
+    details.name = "Primitives";
+    details.customClearValues = true;
+
+    return new Sandbox(details);
+}
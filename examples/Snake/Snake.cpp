@@ -116,7 +116,7 @@ private:
     {
         m_Camera = Eos::OrthographicCamera(m_Window->getSize());
 
-        m_MainEventDispatcher.addCallback(&keyboardEvent, this);
+        m_MainEventDispatcher.addCallback<&Snake::keyboardEvent>(this);
 
         std::vector<Vertex> vertices = {
             { { -1.0f,  1.0f, 0.0f} },
@@ -490,29 +490,27 @@ private:
         return position;
     }
 
-    static bool keyboardEvent(const Eos::Events::KeyInputEvent* event)
+    bool keyboardEvent(const Eos::Events::KeyInputEvent& event)
     {
-        Snake* snake = (Snake*)event->dataPointer;
-
-        if (event->action == Eos::Events::Action::PRESS)
+        if (event.action == Eos::Events::Action::PRESS)
         {
-            if (event->key == Eos::Events::Key::KEY_ESCAPE)
-                snake->m_Window->setWindowShouldClose(true);
+            if (event.key == Eos::Events::Key::KEY_ESCAPE)
+                m_Window->setWindowShouldClose(true);
 
-            if (event->key == Eos::Events::Key::KEY_A)
-                snake->m_MoveQueue.push(SnakeDirection::LEFT);
+            if (event.key == Eos::Events::Key::KEY_A)
+                m_MoveQueue.push(SnakeDirection::LEFT);
 
-            if (event->key == Eos::Events::Key::KEY_D)
-                snake->m_MoveQueue.push(SnakeDirection::RIGHT);
+            if (event.key == Eos::Events::Key::KEY_D)
+                m_MoveQueue.push(SnakeDirection::RIGHT);
 
-            if (event->key == Eos::Events::Key::KEY_W)
-                snake->m_MoveQueue.push(SnakeDirection::UP);
+            if (event.key == Eos::Events::Key::KEY_W)
+                m_MoveQueue.push(SnakeDirection::UP);
 
-            if (event->key == Eos::Events::Key::KEY_S)
-                snake->m_MoveQueue.push(SnakeDirection::DOWN);
+            if (event.key == Eos::Events::Key::KEY_S)
+                m_MoveQueue.push(SnakeDirection::DOWN);
 
-            if (event->key == Eos::Events::Key::KEY_SPACE)
-                snake->increaseSnakeLength();
+            if (event.key == Eos::Events::Key::KEY_SPACE)
+                increaseSnakeLength();
         }
 
         return true;